@@ -9,49 +9,66 @@
 #include <iomanip>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
 #include <iterator>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
 
-using namespace std;
-using namespace chrono;
+#include "aes.h"
 
-// AESֵ֧Կ
-enum KeyLength {
-    AES_128,  // 128λԿ
-    AES_192,  // 192λԿ
-    AES_256   // 256λԿ
-};
+// x86/x64ƽ̨ϱAES-NIˣʱͨCPUIDǷ
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AES_HAVE_AESNI 1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AESNI_TARGET
+#define CLMUL_TARGET
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#define CLMUL_TARGET __attribute__((target("aes,sse2,ssse3,pclmul")))
+#endif
+#else
+#define AES_HAVE_AESNI 0
+#endif
 
-// AESģʽ
-enum AESMode {
-    ECB,    // 뱾ģʽ
-    CBC,    // ģʽ
-    CFB,    // 뷴ģʽ
-    OFB,    // ģʽ
-    CTR     // ģʽ
-};
+// ֽСϰС˶дֱֿӿ
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define AES_LITTLE_ENDIAN 1
+#else
+#define AES_LITTLE_ENDIAN 0
+#endif
 
-// ģʽ
-enum OperationMode {
-    ENCRYPT,
-    DECRYPT
-};
+// ڴӳļ
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-// вṹ
-struct Args {
-    OperationMode opMode;
-    AESMode aesMode;
-    KeyLength keyLen;
-    string key;       // Կ
-    string iv;        // ʼ
-    string inputFile;
-    string outputFile;
-};
+using namespace std;
+using namespace chrono;
+
+namespace aes {
 
 // AES - 
 const int ROUNDS[3] = { 10, 12, 14 }; // 128, 192, 256λԿӦ
 
 // S
-const uint8_t S_BOX[256] = {
+constexpr uint8_t S_BOX[256] = {
     0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
     0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
     0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
@@ -71,7 +88,7 @@ const uint8_t S_BOX[256] = {
 };
 
 // S
-const uint8_t INV_S_BOX[256] = {
+constexpr uint8_t INV_S_BOX[256] = {
     0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
     0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
     0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
@@ -104,6 +121,21 @@ void xorBytes(uint8_t* dest, const uint8_t* src, size_t len) {
     }
 }
 
+// ߺout = a ^ b8ִֽʣಿְֽڴ
+void xorBlocks(uint8_t* out, const uint8_t* a, const uint8_t* b, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        x ^= y;
+        memcpy(out + i, &x, 8);
+    }
+    for (; i < len; ++i) {
+        out[i] = a[i] ^ b[i];
+    }
+}
+
 // ߺS滻
 void subBytes(uint8_t* state) {
     for (int i = 0; i < 16; ++i) {
@@ -169,14 +201,13 @@ void invShiftRows(uint8_t* state) {
 }
 
 // GF(2^8)˷
-uint8_t gmul(uint8_t a, uint8_t b) {
+constexpr uint8_t gmul(uint8_t a, uint8_t b) {
     uint8_t p = 0;
-    uint8_t hi_bit_set;
     for (int i = 0; i < 8; i++) {
         if (b & 1) {
             p ^= a;
         }
-        hi_bit_set = a & 0x80;
+        uint8_t hi_bit_set = a & 0x80;
         a <<= 1;
         if (hi_bit_set) {
             a ^= 0x1b; // x^8 + x^4 + x^3 + x + 1
@@ -217,7 +248,16 @@ void invMixColumns(uint8_t* state) {
 }
 
 // Կչ
-void keyExpansion(const uint8_t* key, uint8_t* w, KeyLength keyLen) {
+// SubWordֵÿֽӦS
+typedef void (*SubWordFunc)(uint8_t* word);
+
+void subWordTable(uint8_t* word) {
+    for (int j = 0; j < 4; j++) {
+        word[j] = S_BOX[word[j]];
+    }
+}
+
+void keyExpansion(const uint8_t* key, uint8_t* w, KeyLength keyLen, SubWordFunc subWord = subWordTable) {
     int Nk = (keyLen == AES_128) ? 4 : (keyLen == AES_192) ? 6 : 8;
     int Nr = ROUNDS[keyLen];
     int i = 0;
@@ -251,18 +291,14 @@ void keyExpansion(const uint8_t* key, uint8_t* w, KeyLength keyLen) {
             temp[3] = t;
 
             // SubWord: ÿֽӦS
-            for (int j = 0; j < 4; j++) {
-                temp[j] = S_BOX[temp[j]];
-            }
+            subWord(temp);
 
             // ֳ
             temp[0] ^= (RCON[i / Nk] >> 24) & 0xFF;
         }
         // AES-256ÿNk+4ִֶһSubWord
         else if (keyLen == AES_256 && i % Nk == 4) {
-            for (int j = 0; j < 4; j++) {
-                temp[j] = S_BOX[temp[j]];
-            }
+            subWord(temp);
         }
 
         // չԿ
@@ -322,446 +358,3875 @@ void aesDecryptBlock(uint8_t* state, const uint8_t* w, KeyLength keyLen) {
     addRoundKey(state, w);
 }
 
-// в
-Args parseArgs(int argc, char* argv[]) {
-    Args args;
-    args.opMode = ENCRYPT; // Ĭϼ
-    args.aesMode = ECB;    // ĬECBģʽ
-    args.keyLen = AES_128; // Ĭ128λԿ
-
-    for (int i = 1; i < argc; ++i) {
-        string arg = argv[i];
-        if (arg == "-m" || arg == "--mode") {
-            if (i + 1 >= argc) throw invalid_argument("ȱģʽֵ");
-            string mode = argv[++i];
-            if (mode == "encrypt") args.opMode = ENCRYPT;
-            else if (mode == "decrypt") args.opMode = DECRYPT;
-            else throw invalid_argument("Чģʽ: " + mode);
-        }
-        else if (arg == "-a" || arg == "--aes-mode") {
-            if (i + 1 >= argc) throw invalid_argument("ȱAESģʽֵ");
-            string mode = argv[++i];
-            if (mode == "ecb") args.aesMode = ECB;
-            else if (mode == "cbc") args.aesMode = CBC;
-            else if (mode == "cfb") args.aesMode = CFB;
-            else if (mode == "ofb") args.aesMode = OFB;
-            else if (mode == "ctr") args.aesMode = CTR;
-            else throw invalid_argument("ЧAESģʽ: " + mode);
-        }
-        else if (arg == "-l" || arg == "--key-length") {
-            if (i + 1 >= argc) throw invalid_argument("ȱԿȲֵ");
-            string len = argv[++i];
-            if (len == "128") args.keyLen = AES_128;
-            else if (len == "192") args.keyLen = AES_192;
-            else if (len == "256") args.keyLen = AES_256;
-            else throw invalid_argument("ЧԿ: " + len);
-        }
-        else if (arg == "-k" || arg == "--key") {
-            if (i + 1 >= argc) throw invalid_argument("ȱԿֵ");
-            args.key = argv[++i];
-            int keySize = (args.keyLen == AES_128) ? 16 : (args.keyLen == AES_192) ? 24 : 32;
-            if (args.key.length() != keySize) {
-                throw invalid_argument("Կ" + to_string(keySize) + "ַ");
-            }
-        }
-        else if (arg == "-i" || arg == "--iv") {
-            if (i + 1 >= argc) throw invalid_argument("ȱٳʼֵ");
-            args.iv = argv[++i];
-            if (args.iv.length() != 16) {
-                throw invalid_argument("ʼ16ַ");
-            }
-        }
-        else if (arg == "-f" || arg == "--file") {
-            if (i + 1 >= argc) throw invalid_argument("ȱļֵ");
-            args.inputFile = argv[++i];
-        }
-        else if (arg == "-o" || arg == "--output") {
-            if (i + 1 >= argc) throw invalid_argument("ȱļֵ");
-            args.outputFile = argv[++i];
-        }
-        else if (arg == "-h" || arg == "--help") {
-            cout << "AESӽܹ" << endl;
-            cout << "÷: " << argv[0] << " [ѡ]" << endl;
-            cout << "ѡ:" << endl;
-            cout << "  -m, --mode       ģʽ: encrypt()  decrypt()Ĭencrypt" << endl;
-            cout << "  -a, --aes-mode   AESģʽ: ecb, cbc, cfb, ofb, ctrĬecb" << endl;
-            cout << "  -l, --key-length Կ: 128, 192, 256Ĭ128" << endl;
-            cout << "  -k, --key        Կ";
-            cout << " 16(AES-128), 24(AES-192)  32(AES-256) ַ" << endl;
-            cout << "  -i, --iv         ʼ16ַ(CBC/CFB/OFB/CTRģʽҪ)" << endl;
-            cout << "  -f, --file       ļ·" << endl;
-            cout << "  -o, --output     ļ·" << endl;
-            cout << "  -h, --help       ʾϢ" << endl;
-            exit(0);
-        }
-        else {
-            throw invalid_argument("ЧĲ: " + arg);
-        }
-    }
+// TSСλлϺϲΪÿ16β
+struct AESTable {
+    uint32_t t[256];
+};
 
-    // ֤Ҫ
-    if (args.inputFile.empty()) {
-        throw invalid_argument("ṩļ");
-    }
-    if (args.outputFile.empty()) {
-        throw invalid_argument("ṩļ");
-    }
-    if (args.key.empty()) {
-        throw invalid_argument("ṩԿ");
-    }
+// ѭ
+constexpr uint32_t rotr32(uint32_t x, int n) {
+    return n == 0 ? x : (x >> n) | (x << (32 - n));
+}
 
-    // ֤Կ
-    int keySize = (args.keyLen == AES_128) ? 16 : (args.keyLen == AES_192) ? 24 : 32;
-    if (args.key.length() != keySize) {
-        throw invalid_argument("Կ" + to_string(keySize) + "ַ");
+// ɼTTE0[x] = (2S[x], S[x], S[x], 3S[x])TE1~TE3Ϊѭ
+constexpr AESTable makeEncTable(int rot) {
+    AESTable table = {};
+    for (int x = 0; x < 256; x++) {
+        uint8_t s = S_BOX[x];
+        uint32_t word = ((uint32_t)gmul(2, s) << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) | gmul(3, s);
+        table.t[x] = rotr32(word, rot * 8);
     }
+    return table;
+}
 
-    // ֤IV
-    if ((args.aesMode == CBC || args.aesMode == CFB || args.aesMode == OFB || args.aesMode == CTR) && args.iv.empty()) {
-        throw invalid_argument("CBC/CFB/OFB/CTRģʽҪʼ");
-    }
-    if (!args.iv.empty() && args.iv.length() != 16) {
-        throw invalid_argument("ʼ16ַ");
+// ɽTTD0[x] = (14S'[x], 9S'[x], 13S'[x], 11S'[x])
+constexpr AESTable makeDecTable(int rot) {
+    AESTable table = {};
+    for (int x = 0; x < 256; x++) {
+        uint8_t s = INV_S_BOX[x];
+        uint32_t word = ((uint32_t)gmul(0x0e, s) << 24) | ((uint32_t)gmul(0x09, s) << 16) |
+            ((uint32_t)gmul(0x0d, s) << 8) | gmul(0x0b, s);
+        table.t[x] = rotr32(word, rot * 8);
     }
-
-    return args;
+    return table;
 }
 
-// ȡļ
-vector<uint8_t> readFile(const string& filename) {
-    ifstream file(filename, ios::binary);
-    if (!file) {
-        throw runtime_error("޷ļ: " + filename);
-    }
+constexpr AESTable TE0 = makeEncTable(0);
+constexpr AESTable TE1 = makeEncTable(1);
+constexpr AESTable TE2 = makeEncTable(2);
+constexpr AESTable TE3 = makeEncTable(3);
+constexpr AESTable TD0 = makeDecTable(0);
+constexpr AESTable TD1 = makeDecTable(1);
+constexpr AESTable TD2 = makeDecTable(2);
+constexpr AESTable TD3 = makeDecTable(3);
 
-    // ȡļС
-    file.seekg(0, ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, ios::beg);
+// д32λ
+inline uint32_t loadBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
 
-    // ȡļ
-    vector<uint8_t> data(size);
-    file.read(reinterpret_cast<char*>(data.data()), size);
+inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
 
-    return data;
+// д64λ
+inline uint64_t loadBE64(const uint8_t* p) {
+    return ((uint64_t)loadBE32(p) << 32) | loadBE32(p + 4);
 }
 
-// дļ
-void writeFile(const string& filename, const vector<uint8_t>& data) {
-    ofstream file(filename, ios::binary);
-    if (!file) {
-        throw runtime_error("޷ļ: " + filename);
+inline void storeBE64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (56 - 8 * i));
     }
+}
 
-    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+// Сд64λ
+inline uint64_t loadLE64(const uint8_t* p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+        ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
 }
 
-// 䣨PKCS#7
-vector<uint8_t> addPadding(const vector<uint8_t>& data) {
-    size_t blockSize = 16;
-    size_t paddingSize = blockSize - (data.size() % blockSize);
-    vector<uint8_t> padded = data;
+inline void storeLE64(uint8_t* p, uint64_t v) {
+#if AES_LITTLE_ENDIAN
+    // ֽдϲһָֻ16ֽڶȡʱ洢תʧܣСֱд
+    memcpy(p, &v, 8);
+#else
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    p[4] = (uint8_t)(v >> 32);
+    p[5] = (uint8_t)(v >> 40);
+    p[6] = (uint8_t)(v >> 48);
+    p[7] = (uint8_t)(v >> 56);
+#endif
+}
 
-    for (size_t i = 0; i < paddingSize; i++) {
-        padded.push_back(static_cast<uint8_t>(paddingSize));
+// ֽʽչԿTԿ
+void keyScheduleEncrypt(const uint8_t* w, uint32_t* ek, KeyLength keyLen) {
+    int words = 4 * (ROUNDS[keyLen] + 1);
+    for (int i = 0; i < words; i++) {
+        ek[i] = loadBE32(w + 4 * i);
     }
-
-    return padded;
 }
 
-// Ƴ
-vector<uint8_t> removePadding(const vector<uint8_t>& data) {
-    if (data.empty()) {
-        return data;
-    }
+// ɵȼĽԿԿ򣬲мԤл
+void keyScheduleDecrypt(const uint32_t* ek, uint32_t* dk, KeyLength keyLen) {
+    int Nr = ROUNDS[keyLen];
 
-    size_t paddingSize = data.back();
-    if (paddingSize > data.size() || paddingSize > 16) {
-        throw runtime_error("Ч");
+    for (int round = 0; round <= Nr; round++) {
+        for (int j = 0; j < 4; j++) {
+            uint32_t k = ek[4 * (Nr - round) + j];
+            if (round > 0 && round < Nr) {
+                // TDn[S[x]] ǡǶԵֽлϵĽ
+                k = TD0.t[S_BOX[k >> 24]] ^ TD1.t[S_BOX[(k >> 16) & 0xff]] ^
+                    TD2.t[S_BOX[(k >> 8) & 0xff]] ^ TD3.t[S_BOX[k & 0xff]];
+            }
+            dk[4 * round + j] = k;
+        }
     }
-
-    return vector<uint8_t>(data.begin(), data.end() - paddingSize);
 }
 
-// ECBģʽ
-vector<uint8_t> ecbEncrypt(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen) {
-    vector<uint8_t> padded = addPadding(data);
-    vector<uint8_t> result;
-    result.reserve(padded.size());
+// AESܣT
+void aesEncryptBlockTTable(const uint8_t* in, uint8_t* out, const uint32_t* ek, int Nr) {
+    uint32_t s0 = loadBE32(in) ^ ek[0];
+    uint32_t s1 = loadBE32(in + 4) ^ ek[1];
+    uint32_t s2 = loadBE32(in + 8) ^ ek[2];
+    uint32_t s3 = loadBE32(in + 12) ^ ek[3];
+    uint32_t t0, t1, t2, t3;
 
-    uint8_t block[16];
+    // ǰNr-1
+    for (int round = 1; round < Nr; round++) {
+        const uint32_t* rk = ek + round * 4;
+        t0 = TE0.t[s0 >> 24] ^ TE1.t[(s1 >> 16) & 0xff] ^ TE2.t[(s2 >> 8) & 0xff] ^ TE3.t[s3 & 0xff] ^ rk[0];
+        t1 = TE0.t[s1 >> 24] ^ TE1.t[(s2 >> 16) & 0xff] ^ TE2.t[(s3 >> 8) & 0xff] ^ TE3.t[s0 & 0xff] ^ rk[1];
+        t2 = TE0.t[s2 >> 24] ^ TE1.t[(s3 >> 16) & 0xff] ^ TE2.t[(s0 >> 8) & 0xff] ^ TE3.t[s1 & 0xff] ^ rk[2];
+        t3 = TE0.t[s3 >> 24] ^ TE1.t[(s0 >> 16) & 0xff] ^ TE2.t[(s1 >> 8) & 0xff] ^ TE3.t[s2 & 0xff] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    // һ֣ûлϣ
+    const uint32_t* rk = ek + Nr * 4;
+    t0 = ((uint32_t)S_BOX[s0 >> 24] << 24) | ((uint32_t)S_BOX[(s1 >> 16) & 0xff] << 16) |
+        ((uint32_t)S_BOX[(s2 >> 8) & 0xff] << 8) | S_BOX[s3 & 0xff];
+    t1 = ((uint32_t)S_BOX[s1 >> 24] << 24) | ((uint32_t)S_BOX[(s2 >> 16) & 0xff] << 16) |
+        ((uint32_t)S_BOX[(s3 >> 8) & 0xff] << 8) | S_BOX[s0 & 0xff];
+    t2 = ((uint32_t)S_BOX[s2 >> 24] << 24) | ((uint32_t)S_BOX[(s3 >> 16) & 0xff] << 16) |
+        ((uint32_t)S_BOX[(s0 >> 8) & 0xff] << 8) | S_BOX[s1 & 0xff];
+    t3 = ((uint32_t)S_BOX[s3 >> 24] << 24) | ((uint32_t)S_BOX[(s0 >> 16) & 0xff] << 16) |
+        ((uint32_t)S_BOX[(s1 >> 8) & 0xff] << 8) | S_BOX[s2 & 0xff];
 
-    // 鴦
-    for (size_t i = 0; i < padded.size(); i += 16) {
-        // ݵ飨޸Ͳƥ⣩
-        memset(block, 0, 16);
-        size_t copySize = min(static_cast<size_t>(16), padded.size() - i);
-        memcpy(block, &padded[i], copySize);
+    storeBE32(out, t0 ^ rk[0]);
+    storeBE32(out + 4, t1 ^ rk[1]);
+    storeBE32(out + 8, t2 ^ rk[2]);
+    storeBE32(out + 12, t3 ^ rk[3]);
+}
 
-        // ܿ
-        aesEncryptBlock(block, w, keyLen);
+// AESܣTʹõȼĽԿ
+void aesDecryptBlockTTable(const uint8_t* in, uint8_t* out, const uint32_t* dk, int Nr) {
+    uint32_t s0 = loadBE32(in) ^ dk[0];
+    uint32_t s1 = loadBE32(in + 4) ^ dk[1];
+    uint32_t s2 = loadBE32(in + 8) ^ dk[2];
+    uint32_t s3 = loadBE32(in + 12) ^ dk[3];
+    uint32_t t0, t1, t2, t3;
 
-        // ܺĿӵ
-        result.insert(result.end(), block, block + 16);
+    // ǰNr-1
+    for (int round = 1; round < Nr; round++) {
+        const uint32_t* rk = dk + round * 4;
+        t0 = TD0.t[s0 >> 24] ^ TD1.t[(s3 >> 16) & 0xff] ^ TD2.t[(s2 >> 8) & 0xff] ^ TD3.t[s1 & 0xff] ^ rk[0];
+        t1 = TD0.t[s1 >> 24] ^ TD1.t[(s0 >> 16) & 0xff] ^ TD2.t[(s3 >> 8) & 0xff] ^ TD3.t[s2 & 0xff] ^ rk[1];
+        t2 = TD0.t[s2 >> 24] ^ TD1.t[(s1 >> 16) & 0xff] ^ TD2.t[(s0 >> 8) & 0xff] ^ TD3.t[s3 & 0xff] ^ rk[2];
+        t3 = TD0.t[s3 >> 24] ^ TD1.t[(s2 >> 16) & 0xff] ^ TD2.t[(s1 >> 8) & 0xff] ^ TD3.t[s0 & 0xff] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
     }
 
-    return result;
+    // һ֣ûлϣ
+    const uint32_t* rk = dk + Nr * 4;
+    t0 = ((uint32_t)INV_S_BOX[s0 >> 24] << 24) | ((uint32_t)INV_S_BOX[(s3 >> 16) & 0xff] << 16) |
+        ((uint32_t)INV_S_BOX[(s2 >> 8) & 0xff] << 8) | INV_S_BOX[s1 & 0xff];
+    t1 = ((uint32_t)INV_S_BOX[s1 >> 24] << 24) | ((uint32_t)INV_S_BOX[(s0 >> 16) & 0xff] << 16) |
+        ((uint32_t)INV_S_BOX[(s3 >> 8) & 0xff] << 8) | INV_S_BOX[s2 & 0xff];
+    t2 = ((uint32_t)INV_S_BOX[s2 >> 24] << 24) | ((uint32_t)INV_S_BOX[(s1 >> 16) & 0xff] << 16) |
+        ((uint32_t)INV_S_BOX[(s0 >> 8) & 0xff] << 8) | INV_S_BOX[s3 & 0xff];
+    t3 = ((uint32_t)INV_S_BOX[s3 >> 24] << 24) | ((uint32_t)INV_S_BOX[(s2 >> 16) & 0xff] << 16) |
+        ((uint32_t)INV_S_BOX[(s1 >> 8) & 0xff] << 8) | INV_S_BOX[s0 & 0xff];
+
+    storeBE32(out, t0 ^ rk[0]);
+    storeBE32(out + 4, t1 ^ rk[1]);
+    storeBE32(out + 8, t2 ^ rk[2]);
+    storeBE32(out + 12, t3 ^ rk[3]);
 }
 
-// ECBģʽ
-vector<uint8_t> ecbDecrypt(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen) {
-    if (data.size() % 16 != 0) {
-        throw runtime_error("ݳȱ16ı");
-    }
+// λƬʵ֣8ͬһλͬһ64λ֣Sò·㣬㶼޹ص
+// ߼λ޷ִ֧ʱԿ޹أʺûAESָƽ̨
+const int BITSLICE_BLOCKS = 8;
 
-    vector<uint8_t> result;
-    result.reserve(data.size());
+// amaskѡеλbиnλӦλ
+inline void swapMove(uint64_t& a, uint64_t& b, uint64_t mask, int n) {
+    uint64_t t = ((b >> n) ^ a) & mask;
+    a ^= t;
+    b ^= t << n;
+}
 
-    uint8_t block[16];
+// 8x8λתãתúq[j]ĵkֽڵĵiλ = תǰq[i]ĵkֽڵĵjλΪ任
+void bitsliceTranspose(uint64_t* q) {
+    swapMove(q[1], q[0], 0x5555555555555555ULL, 1);
+    swapMove(q[3], q[2], 0x5555555555555555ULL, 1);
+    swapMove(q[5], q[4], 0x5555555555555555ULL, 1);
+    swapMove(q[7], q[6], 0x5555555555555555ULL, 1);
+    swapMove(q[2], q[0], 0x3333333333333333ULL, 2);
+    swapMove(q[3], q[1], 0x3333333333333333ULL, 2);
+    swapMove(q[6], q[4], 0x3333333333333333ULL, 2);
+    swapMove(q[7], q[5], 0x3333333333333333ULL, 2);
+    swapMove(q[4], q[0], 0x0F0F0F0F0F0F0F0FULL, 4);
+    swapMove(q[5], q[1], 0x0F0F0F0F0F0F0F0FULL, 4);
+    swapMove(q[6], q[2], 0x0F0F0F0F0F0F0F0FULL, 4);
+    swapMove(q[7], q[3], 0x0F0F0F0F0F0F0F0FULL, 4);
+}
 
-    // 鴦
-    for (size_t i = 0; i < data.size(); i += 16) {
-        // ݵ
-        memcpy(block, &data[i], 16);
+// żλõ4ֽ£32λ
+inline uint64_t unzipBytes(uint64_t x) {
+    x &= 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    return (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+}
 
-        // ܿ
-        aesDecryptBlock(block, w, keyLen);
+// unzipBytes任ѵ32λ4ֽڷɢżλ
+inline uint64_t zipBytes(uint64_t x) {
+    x &= 0x00000000FFFFFFFFULL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    return (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+}
 
-        // ܺĿӵ
-        result.insert(result.end(), block, block + 16);
+// 4תΪλƬʽq[j]ֽڵĵjλbpֽλڵ4p + bλ
+// cеrλڵ16c + 4r + bλλл϶λ
+void bitslicePack(uint64_t* q, const uint8_t* in) {
+    for (int b = 0; b < 4; b++) {
+        uint64_t lo = loadLE64(in + b * 16);
+        uint64_t hi = loadLE64(in + b * 16 + 8);
+        q[b] = unzipBytes(lo) | (unzipBytes(hi) << 32);
+        q[b + 4] = unzipBytes(lo >> 8) | (unzipBytes(hi >> 8) << 32);
     }
+    bitsliceTranspose(q);
+}
 
-    // Ƴ
-    return removePadding(result);
+void bitsliceUnpack(uint8_t* out, uint64_t* q) {
+    bitsliceTranspose(q);
+    for (int b = 0; b < 4; b++) {
+        storeLE64(out + b * 16, zipBytes(q[b]) | (zipBytes(q[b + 4]) << 8));
+        storeLE64(out + b * 16 + 8, zipBytes(q[b] >> 32) | (zipBytes(q[b + 4] >> 32) << 8));
+    }
 }
 
-// CBCģʽ
-vector<uint8_t> cbcEncrypt(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen, const uint8_t* iv) {
-    vector<uint8_t> padded = addPadding(data);
-    vector<uint8_t> result;
-    result.reserve(padded.size());
+// Sе·Boyar-Peralta113߼ţԱ任GF(2^4)ϵ桢ײԱ任
+void bitsliceSubBytes(uint64_t* q) {
+    uint64_t x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4];
+    uint64_t x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
 
-    uint8_t block[16];
-    uint8_t prevBlock[16];
-    memcpy(prevBlock, iv, 16);
+    uint64_t y14 = x3 ^ x5;
+    uint64_t y13 = x0 ^ x6;
+    uint64_t y9 = x0 ^ x3;
+    uint64_t y8 = x0 ^ x5;
+    uint64_t t0 = x1 ^ x2;
+    uint64_t y1 = t0 ^ x7;
+    uint64_t y4 = y1 ^ x3;
+    uint64_t y12 = y13 ^ y14;
+    uint64_t y2 = y1 ^ x0;
+    uint64_t y5 = y1 ^ x6;
+    uint64_t y3 = y5 ^ y8;
+    uint64_t t1 = x4 ^ y12;
+    uint64_t y15 = t1 ^ x5;
+    uint64_t y20 = t1 ^ x1;
+    uint64_t y6 = y15 ^ x7;
+    uint64_t y10 = y15 ^ t0;
+    uint64_t y11 = y20 ^ y9;
+    uint64_t y7 = x7 ^ y11;
+    uint64_t y17 = y10 ^ y11;
+    uint64_t y19 = y10 ^ y8;
+    uint64_t y16 = t0 ^ y11;
+    uint64_t y21 = y13 ^ y16;
+    uint64_t y18 = x0 ^ y16;
 
-    // 鴦
-    for (size_t i = 0; i < padded.size(); i += 16) {
-        // ݵ鲢ǰһ޸Ͳƥ⣩
-        memset(block, 0, 16);
-        size_t copySize = min(static_cast<size_t>(16), padded.size() - i);
-        memcpy(block, &padded[i], copySize);
-        xorBytes(block, prevBlock, 16);
+    uint64_t t2 = y12 & y15;
+    uint64_t t3 = y3 & y6;
+    uint64_t t4 = t3 ^ t2;
+    uint64_t t5 = y4 & x7;
+    uint64_t t6 = t5 ^ t2;
+    uint64_t t7 = y13 & y16;
+    uint64_t t8 = y5 & y1;
+    uint64_t t9 = t8 ^ t7;
+    uint64_t t10 = y2 & y7;
+    uint64_t t11 = t10 ^ t7;
+    uint64_t t12 = y9 & y11;
+    uint64_t t13 = y14 & y17;
+    uint64_t t14 = t13 ^ t12;
+    uint64_t t15 = y8 & y10;
+    uint64_t t16 = t15 ^ t12;
+    uint64_t t17 = t4 ^ t14;
+    uint64_t t18 = t6 ^ t16;
+    uint64_t t19 = t9 ^ t14;
+    uint64_t t20 = t11 ^ t16;
+    uint64_t t21 = t17 ^ y20;
+    uint64_t t22 = t18 ^ y19;
+    uint64_t t23 = t19 ^ y21;
+    uint64_t t24 = t20 ^ y18;
 
-        // ܿ
-        aesEncryptBlock(block, w, keyLen);
-        memcpy(prevBlock, block, 16);
+    uint64_t t25 = t21 ^ t22;
+    uint64_t t26 = t21 & t23;
+    uint64_t t27 = t24 ^ t26;
+    uint64_t t28 = t25 & t27;
+    uint64_t t29 = t28 ^ t22;
+    uint64_t t30 = t23 ^ t24;
+    uint64_t t31 = t22 ^ t26;
+    uint64_t t32 = t31 & t30;
+    uint64_t t33 = t32 ^ t24;
+    uint64_t t34 = t23 ^ t33;
+    uint64_t t35 = t27 ^ t33;
+    uint64_t t36 = t24 & t35;
+    uint64_t t37 = t36 ^ t34;
+    uint64_t t38 = t27 ^ t36;
+    uint64_t t39 = t29 & t38;
+    uint64_t t40 = t25 ^ t39;
 
-        // ܺĿӵ
-        result.insert(result.end(), block, block + 16);
-    }
+    uint64_t t41 = t40 ^ t37;
+    uint64_t t42 = t29 ^ t33;
+    uint64_t t43 = t29 ^ t40;
+    uint64_t t44 = t33 ^ t37;
+    uint64_t t45 = t42 ^ t41;
+    uint64_t z0 = t44 & y15;
+    uint64_t z1 = t37 & y6;
+    uint64_t z2 = t33 & x7;
+    uint64_t z3 = t43 & y16;
+    uint64_t z4 = t40 & y1;
+    uint64_t z5 = t29 & y7;
+    uint64_t z6 = t42 & y11;
+    uint64_t z7 = t45 & y17;
+    uint64_t z8 = t41 & y10;
+    uint64_t z9 = t44 & y12;
+    uint64_t z10 = t37 & y3;
+    uint64_t z11 = t33 & y4;
+    uint64_t z12 = t43 & y13;
+    uint64_t z13 = t40 & y5;
+    uint64_t z14 = t29 & y2;
+    uint64_t z15 = t42 & y9;
+    uint64_t z16 = t45 & y14;
+    uint64_t z17 = t41 & y8;
 
-    return result;
+    uint64_t t46 = z15 ^ z16;
+    uint64_t t47 = z10 ^ z11;
+    uint64_t t48 = z5 ^ z13;
+    uint64_t t49 = z9 ^ z10;
+    uint64_t t50 = z2 ^ z12;
+    uint64_t t51 = z2 ^ z5;
+    uint64_t t52 = z7 ^ z8;
+    uint64_t t53 = z0 ^ z3;
+    uint64_t t54 = z6 ^ z7;
+    uint64_t t55 = z16 ^ z17;
+    uint64_t t56 = z12 ^ t48;
+    uint64_t t57 = t50 ^ t53;
+    uint64_t t58 = z4 ^ t46;
+    uint64_t t59 = z3 ^ t54;
+    uint64_t t60 = t46 ^ t57;
+    uint64_t t61 = z14 ^ t57;
+    uint64_t t62 = t52 ^ t58;
+    uint64_t t63 = t49 ^ t58;
+    uint64_t t64 = z4 ^ t59;
+    uint64_t t65 = t61 ^ t62;
+    uint64_t t66 = z1 ^ t63;
+    uint64_t s0 = t59 ^ t63;
+    uint64_t s6 = t56 ^ ~t62;
+    uint64_t s7 = t48 ^ ~t60;
+    uint64_t t67 = t64 ^ t65;
+    uint64_t s3 = t53 ^ t66;
+    uint64_t s4 = t51 ^ t66;
+    uint64_t s5 = t47 ^ t65;
+    uint64_t s1 = t64 ^ ~s3;
+    uint64_t s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
 }
 
-// CBCģʽ
-vector<uint8_t> cbcDecrypt(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen, const uint8_t* iv) {
-    if (data.size() % 16 != 0) {
-        throw runtime_error("ݳȱ16ı");
+// Sе任y' = (y <<< 1) ^ (y <<< 3) ^ (y <<< 6) ^ 0x05
+void bitsliceInvAffine(uint64_t* q) {
+    uint64_t y[8];
+    for (int i = 0; i < 8; i++) {
+        y[i] = q[(i + 7) & 7] ^ q[(i + 5) & 7] ^ q[(i + 2) & 7];
     }
+    y[0] = ~y[0];
+    y[2] = ~y[2];
+    memcpy(q, y, sizeof(y));
+}
 
-    vector<uint8_t> result;
-    result.reserve(data.size());
+// SУInvS = A^-1  S  A^-1S = A  棬AΪ任
+void bitsliceInvSubBytes(uint64_t* q) {
+    bitsliceInvAffine(q);
+    bitsliceSubBytes(q);
+    bitsliceInvAffine(q);
+}
 
-    uint8_t block[16];
-    uint8_t prevBlock[16];
-    uint8_t decryptedBlock[16];
+// 64λѭλ
+inline uint64_t rotr64(uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
 
-    memcpy(prevBlock, iv, 16);
+// λrеĸλÿ16λеĵ4r~4r+3λѭ16rλr
+void bitsliceShiftRows(uint64_t* q) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000F000F000F000FULL) |
+            rotr64(x & 0x00F000F000F000F0ULL, 16) |
+            rotr64(x & 0x0F000F000F000F00ULL, 32) |
+            rotr64(x & 0xF000F000F000F000ULL, 48);
+    }
+}
+
+void bitsliceInvShiftRows(uint64_t* q) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000F000F000F000FULL) |
+            rotr64(x & 0x00F000F000F000F0ULL, 48) |
+            rotr64(x & 0x0F000F000F000F00ULL, 32) |
+            rotr64(x & 0xF000F000F000F000ULL, 16);
+    }
+}
 
-    // 鴦
-    for (size_t i = 0; i < data.size(); i += 16) {
-        // ݵ
-        memcpy(block, &data[i], 16);
+// ѭƶһУµĵrΪԭr+1У
+inline uint64_t rotateRows1(uint64_t x) {
+    return ((x >> 4) & 0x0FFF0FFF0FFF0FFFULL) | ((x & 0x000F000F000F000FULL) << 12);
+}
 
-        // ܿ
-        memcpy(decryptedBlock, block, 16);
-        aesDecryptBlock(decryptedBlock, w, keyLen);
+// ѭƶ
+inline uint64_t rotateRows2(uint64_t x) {
+    return ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+}
 
-        // ǰһ
-        xorBytes(decryptedBlock, prevBlock, 16);
-        memcpy(prevBlock, block, 16);
+// λƽxģx^8 + x^4 + x^3 + x + 1
+inline void bitsliceXtime(uint64_t* t) {
+    uint64_t hi = t[7];
+    t[7] = t[6];
+    t[6] = t[5];
+    t[5] = t[4];
+    t[4] = t[3] ^ hi;
+    t[3] = t[2] ^ hi;
+    t[2] = t[1];
+    t[1] = t[0] ^ hi;
+    t[0] = hi;
+}
 
-        // ܺĿӵ
-        result.insert(result.end(), decryptedBlock, decryptedBlock + 16);
+// лϣout_r = 2s_r ^ 3s_{r+1} ^ s_{r+2} ^ s_{r+3} = 2t_r ^ s_{r+1} ^ t_{r+2}t = s ^ s_{r+1}
+void bitsliceMixColumns(uint64_t* q) {
+    uint64_t r1[8];
+    uint64_t t[8];
+    for (int i = 0; i < 8; i++) {
+        r1[i] = rotateRows1(q[i]);
+        t[i] = q[i] ^ r1[i];
+    }
+    for (int i = 0; i < 8; i++) {
+        q[i] = r1[i] ^ rotateRows2(t[i]);
+    }
+    bitsliceXtime(t);
+    for (int i = 0; i < 8; i++) {
+        q[i] ^= t[i];
     }
+}
 
-    // Ƴ
-    return removePadding(result);
+// лϣ = л  (04x^2 + 05)ȼs ^ 4(s ^ s_{r+2})л
+void bitsliceInvMixColumns(uint64_t* q) {
+    uint64_t t[8];
+    for (int i = 0; i < 8; i++) {
+        t[i] = q[i] ^ rotateRows2(q[i]);
+    }
+    bitsliceXtime(t);
+    bitsliceXtime(t);
+    for (int i = 0; i < 8; i++) {
+        q[i] ^= t[i];
+    }
+    bitsliceMixColumns(q);
 }
 
-// CFBģʽܺͽͬ
-vector<uint8_t> cfbProcess(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen, const uint8_t* iv) {
-    vector<uint8_t> result;
-    result.reserve(data.size());
+inline void bitsliceAddRoundKey(uint64_t* q, const uint64_t* rk) {
+    for (int i = 0; i < 8; i++) {
+        q[i] ^= rk[i];
+    }
+}
 
-    uint8_t registerValue[16];
-    uint8_t encryptedReg[16];
-    memcpy(registerValue, iv, 16);
+// λƬԿÿԿƵ4λúתΪλƬʽ
+void bitsliceKeySchedule(const uint8_t* w, uint64_t (*rk)[8], int Nr) {
+    uint8_t copies[64];
+    for (int round = 0; round <= Nr; round++) {
+        for (int b = 0; b < 4; b++) {
+            memcpy(copies + b * 16, w + round * 16, 16);
+        }
+        bitslicePack(rk[round], copies);
+    }
+}
 
-    // ֽڴ
-    for (uint8_t byte : data) {
-        // ܼĴ
-        memcpy(encryptedReg, registerValue, 16);
-        aesEncryptBlock(encryptedReg, w, keyLen);
+// ʱSubWord4ֽڷλƬǰ4λãSе·㣬Կչ
+void subWordBitslice(uint8_t* word) {
+    uint64_t q[8];
+    for (int j = 0; j < 8; j++) {
+        q[j] = 0;
+        for (int i = 0; i < 4; i++) {
+            q[j] |= static_cast<uint64_t>((word[i] >> j) & 1) << i;
+        }
+    }
+    bitsliceSubBytes(q);
+    for (int i = 0; i < 4; i++) {
+        uint8_t v = 0;
+        for (int j = 0; j < 8; j++) {
+            v |= static_cast<uint8_t>(((q[j] >> i) & 1) << j);
+        }
+        word[i] = v;
+    }
+}
 
-        // ȡܽĵһֽֽ
-        uint8_t outputByte = byte ^ encryptedReg[0];
-        result.push_back(outputByte);
+// 8飺ǰ4ͺ4ռһλƽ棬㻥Խִ
+void bitsliceEncrypt8(const uint8_t* in, uint8_t* out, const uint64_t (*rk)[8], int Nr) {
+    uint64_t q[2][8];
+    bitslicePack(q[0], in);
+    bitslicePack(q[1], in + 64);
 
-        // λĴ
-        memmove(registerValue, registerValue + 1, 15);
-        registerValue[15] = outputByte;
+    for (int h = 0; h < 2; h++) {
+        bitsliceAddRoundKey(q[h], rk[0]);
+    }
+    for (int round = 1; round < Nr; round++) {
+        for (int h = 0; h < 2; h++) {
+            bitsliceSubBytes(q[h]);
+            bitsliceShiftRows(q[h]);
+            bitsliceMixColumns(q[h]);
+            bitsliceAddRoundKey(q[h], rk[round]);
+        }
+    }
+    for (int h = 0; h < 2; h++) {
+        bitsliceSubBytes(q[h]);
+        bitsliceShiftRows(q[h]);
+        bitsliceAddRoundKey(q[h], rk[Nr]);
     }
 
-    return result;
+    bitsliceUnpack(out, q[0]);
+    bitsliceUnpack(out + 64, q[1]);
 }
 
-// OFBģʽܺͽͬ
-vector<uint8_t> ofbProcess(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen, const uint8_t* iv) {
-    vector<uint8_t> result;
-    result.reserve(data.size());
-
-    uint8_t registerValue[16];
-    uint8_t encryptedReg[16];
-    memcpy(registerValue, iv, 16);
-
-    // ֽڴ
-    for (uint8_t byte : data) {
-        // ܼĴ
-        memcpy(encryptedReg, registerValue, 16);
-        aesEncryptBlock(encryptedReg, w, keyLen);
-        memcpy(registerValue, encryptedReg, 16);
+// 8飨׼ṹʹüԿ
+void bitsliceDecrypt8(const uint8_t* in, uint8_t* out, const uint64_t (*rk)[8], int Nr) {
+    uint64_t q[2][8];
+    bitslicePack(q[0], in);
+    bitslicePack(q[1], in + 64);
 
-        // ȡܽĵһֽֽ
-        result.push_back(byte ^ encryptedReg[0]);
+    for (int h = 0; h < 2; h++) {
+        bitsliceAddRoundKey(q[h], rk[Nr]);
+    }
+    for (int round = Nr - 1; round > 0; round--) {
+        for (int h = 0; h < 2; h++) {
+            bitsliceInvShiftRows(q[h]);
+            bitsliceInvSubBytes(q[h]);
+            bitsliceAddRoundKey(q[h], rk[round]);
+            bitsliceInvMixColumns(q[h]);
+        }
+    }
+    for (int h = 0; h < 2; h++) {
+        bitsliceInvShiftRows(q[h]);
+        bitsliceInvSubBytes(q[h]);
+        bitsliceAddRoundKey(q[h], rk[0]);
     }
 
-    return result;
+    bitsliceUnpack(out, q[0]);
+    bitsliceUnpack(out + 64, q[1]);
 }
 
-// CTRģʽܺͽͬ
-vector<uint8_t> ctrProcess(const vector<uint8_t>& data, const uint8_t* w, KeyLength keyLen, const uint8_t* iv) {
-    vector<uint8_t> result;
-    result.reserve(data.size());
+// n飺ÿ8飬8ʱֻȡҪĽ
+void bitsliceCryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const uint64_t (*rk)[8], int Nr, bool encrypt) {
+    size_t i = 0;
+    for (; i + BITSLICE_BLOCKS <= n; i += BITSLICE_BLOCKS) {
+        if (encrypt) {
+            bitsliceEncrypt8(in + i * 16, out + i * 16, rk, Nr);
+        }
+        else {
+            bitsliceDecrypt8(in + i * 16, out + i * 16, rk, Nr);
+        }
+    }
+
+    if (i < n) {
+        uint8_t buf[BITSLICE_BLOCKS * 16] = {};
+        memcpy(buf, in + i * 16, (n - i) * 16);
+        if (encrypt) {
+            bitsliceEncrypt8(buf, buf, rk, Nr);
+        }
+        else {
+            bitsliceDecrypt8(buf, buf, rk, Nr);
+        }
+        memcpy(out + i * 16, buf, (n - i) * 16);
+    }
+}
+
+#if AES_HAVE_AESNI
+// CPUǷ֧AES-NICPUID.1:ECX.AES[bit 25]ͬʱҪSSE2
+bool cpuHasAESNI() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 25)) != 0 && (info[3] & (1 << 26)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & (1u << 25)) != 0 && (edx & (1u << 26)) != 0;
+#endif
+}
+
+// CPUǷ֧޽λ˷CPUID.1:ECX.PCLMULQDQ[bit 1]ֽҪSSSE3[bit 9]
+bool cpuHasPCLMUL() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0 && (info[2] & (1 << 9)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & (1u << 1)) != 0 && (ecx & (1u << 9)) != 0;
+#endif
+}
+
+// λۼ(w0, w0^w1, w0^w1^w2, w0^w1^w2^w3)
+AESNI_TARGET inline __m128i aesniPrefixXor(__m128i x) {
+    x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+    return _mm_xor_si128(x, _mm_slli_si128(x, 8));
+}
+
+// AES-128/256һչassistΪaeskeygenassistĽlaneѡʹõ
+AESNI_TARGET inline __m128i aesniExpandStep(__m128i key, __m128i assist, int lane) {
+    assist = (lane == 3) ? _mm_shuffle_epi32(assist, 0xff) : _mm_shuffle_epi32(assist, 0xaa);
+    return _mm_xor_si128(aesniPrefixXor(key), assist);
+}
+
+// AES-192һչͬʱ6֣temp1Ϊǰ4֣temp32Ϊ2֣
+AESNI_TARGET inline void aesniExpand192Step(__m128i& temp1, __m128i& temp3, __m128i assist) {
+    assist = _mm_shuffle_epi32(assist, 0x55);
+    temp1 = _mm_xor_si128(aesniPrefixXor(temp1), assist);
+    __m128i last = _mm_shuffle_epi32(temp1, 0xff);
+    temp3 = _mm_xor_si128(temp3, _mm_slli_si128(temp3, 4));
+    temp3 = _mm_xor_si128(temp3, last);
+}
+
+// ƴĴ64λ벿
+AESNI_TARGET inline __m128i aesniShuffle64(__m128i a, __m128i b, int imm) {
+    return imm == 0
+        ? _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), 0))
+        : _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), 1));
+}
+
+// aeskeygenassistԿչԿ16ֽڶдrk
+AESNI_TARGET void aesniKeyExpansion(const uint8_t* key, uint8_t* rk, KeyLength keyLen) {
+    __m128i* ks = reinterpret_cast<__m128i*>(rk);
+
+    if (keyLen == AES_128) {
+        __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+        ks[0] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x01), 3); ks[1] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x02), 3); ks[2] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x04), 3); ks[3] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x08), 3); ks[4] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x10), 3); ks[5] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x20), 3); ks[6] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x40), 3); ks[7] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x80), 3); ks[8] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x1b), 3); ks[9] = k;
+        k = aesniExpandStep(k, _mm_aeskeygenassist_si128(k, 0x36), 3); ks[10] = k;
+    }
+    else if (keyLen == AES_192) {
+        // Կֻ24ֽڣȸƵԽȡ
+        uint8_t buf[32] = {};
+        memcpy(buf, key, 24);
+        __m128i temp1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+        __m128i temp3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 16));
+
+        ks[0] = temp1;
+        ks[1] = temp3;
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x01));
+        ks[1] = aesniShuffle64(ks[1], temp1, 0);
+        ks[2] = aesniShuffle64(temp1, temp3, 1);
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x02));
+        ks[3] = temp1;
+        ks[4] = temp3;
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x04));
+        ks[4] = aesniShuffle64(ks[4], temp1, 0);
+        ks[5] = aesniShuffle64(temp1, temp3, 1);
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x08));
+        ks[6] = temp1;
+        ks[7] = temp3;
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x10));
+        ks[7] = aesniShuffle64(ks[7], temp1, 0);
+        ks[8] = aesniShuffle64(temp1, temp3, 1);
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x20));
+        ks[9] = temp1;
+        ks[10] = temp3;
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x40));
+        ks[10] = aesniShuffle64(ks[10], temp1, 0);
+        ks[11] = aesniShuffle64(temp1, temp3, 1);
+        aesniExpand192Step(temp1, temp3, _mm_aeskeygenassist_si128(temp3, 0x80));
+        ks[12] = temp1;
+    }
+    else {
+        __m128i k0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+        __m128i k1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 16));
+        ks[0] = k0;
+        ks[1] = k1;
+        // żԿʹRotWord+SubWord+RconԿֻʹSubWord
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x01), 3); ks[2] = k0;
+        k1 = aesniExpandStep(k1, _mm_aeskeygenassist_si128(k0, 0x00), 2); ks[3] = k1;
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x02), 3); ks[4] = k0;
+        k1 = aesniExpandStep(k1, _mm_aeskeygenassist_si128(k0, 0x00), 2); ks[5] = k1;
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x04), 3); ks[6] = k0;
+        k1 = aesniExpandStep(k1, _mm_aeskeygenassist_si128(k0, 0x00), 2); ks[7] = k1;
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x08), 3); ks[8] = k0;
+        k1 = aesniExpandStep(k1, _mm_aeskeygenassist_si128(k0, 0x00), 2); ks[9] = k1;
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x10), 3); ks[10] = k0;
+        k1 = aesniExpandStep(k1, _mm_aeskeygenassist_si128(k0, 0x00), 2); ks[11] = k1;
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x20), 3); ks[12] = k0;
+        k1 = aesniExpandStep(k1, _mm_aeskeygenassist_si128(k0, 0x00), 2); ks[13] = k1;
+        k0 = aesniExpandStep(k0, _mm_aeskeygenassist_si128(k1, 0x40), 3); ks[14] = k0;
+    }
+}
+
+// ɵȼĽԿ򲢶мAESIMC
+AESNI_TARGET void aesniKeyScheduleDecrypt(const uint8_t* ek, uint8_t* dk, int Nr) {
+    const __m128i* src = reinterpret_cast<const __m128i*>(ek);
+    __m128i* dst = reinterpret_cast<__m128i*>(dk);
+
+    dst[0] = src[Nr];
+    for (int round = 1; round < Nr; round++) {
+        dst[round] = _mm_aesimc_si128(src[Nr - round]);
+    }
+    dst[Nr] = src[0];
+}
+
+// AESܣAES-NI
+AESNI_TARGET void aesniEncryptBlock(const uint8_t* in, uint8_t* out, const uint8_t* rk, int Nr) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(rk);
+    __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), k[0]);
+    for (int round = 1; round < Nr; round++) {
+        b = _mm_aesenc_si128(b, k[round]);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesenclast_si128(b, k[Nr]));
+}
+
+// AESܣAES-NIʹõȼĽԿ
+AESNI_TARGET void aesniDecryptBlock(const uint8_t* in, uint8_t* out, const uint8_t* rk, int Nr) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(rk);
+    __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), k[0]);
+    for (int round = 1; round < Nr; round++) {
+        b = _mm_aesdec_si128(b, k[round]);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesdeclast_si128(b, k[Nr]));
+}
+
+// ˮߣÿͬʱ8໥Ŀ飬AESENC/AESDECָӳ
+const int AESNI_LANES = 8;
+
+AESNI_TARGET void aesniEncryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const uint8_t* rk, int Nr) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(rk);
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    size_t i = 0;
+
+    for (; i + AESNI_LANES <= n; i += AESNI_LANES) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + i + 1), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + i + 2), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + i + 3), k[0]);
+        __m128i b4 = _mm_xor_si128(_mm_loadu_si128(src + i + 4), k[0]);
+        __m128i b5 = _mm_xor_si128(_mm_loadu_si128(src + i + 5), k[0]);
+        __m128i b6 = _mm_xor_si128(_mm_loadu_si128(src + i + 6), k[0]);
+        __m128i b7 = _mm_xor_si128(_mm_loadu_si128(src + i + 7), k[0]);
+        for (int round = 1; round < Nr; round++) {
+            __m128i rkey = k[round];
+            b0 = _mm_aesenc_si128(b0, rkey);
+            b1 = _mm_aesenc_si128(b1, rkey);
+            b2 = _mm_aesenc_si128(b2, rkey);
+            b3 = _mm_aesenc_si128(b3, rkey);
+            b4 = _mm_aesenc_si128(b4, rkey);
+            b5 = _mm_aesenc_si128(b5, rkey);
+            b6 = _mm_aesenc_si128(b6, rkey);
+            b7 = _mm_aesenc_si128(b7, rkey);
+        }
+        __m128i rkey = k[Nr];
+        _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b0, rkey));
+        _mm_storeu_si128(dst + i + 1, _mm_aesenclast_si128(b1, rkey));
+        _mm_storeu_si128(dst + i + 2, _mm_aesenclast_si128(b2, rkey));
+        _mm_storeu_si128(dst + i + 3, _mm_aesenclast_si128(b3, rkey));
+        _mm_storeu_si128(dst + i + 4, _mm_aesenclast_si128(b4, rkey));
+        _mm_storeu_si128(dst + i + 5, _mm_aesenclast_si128(b5, rkey));
+        _mm_storeu_si128(dst + i + 6, _mm_aesenclast_si128(b6, rkey));
+        _mm_storeu_si128(dst + i + 7, _mm_aesenclast_si128(b7, rkey));
+    }
+
+    for (; i < n; i++) {
+        aesniEncryptBlock(in + i * 16, out + i * 16, rk, Nr);
+    }
+}
+
+AESNI_TARGET void aesniDecryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const uint8_t* rk, int Nr) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(rk);
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    size_t i = 0;
+
+    for (; i + AESNI_LANES <= n; i += AESNI_LANES) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + i + 1), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + i + 2), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + i + 3), k[0]);
+        __m128i b4 = _mm_xor_si128(_mm_loadu_si128(src + i + 4), k[0]);
+        __m128i b5 = _mm_xor_si128(_mm_loadu_si128(src + i + 5), k[0]);
+        __m128i b6 = _mm_xor_si128(_mm_loadu_si128(src + i + 6), k[0]);
+        __m128i b7 = _mm_xor_si128(_mm_loadu_si128(src + i + 7), k[0]);
+        for (int round = 1; round < Nr; round++) {
+            __m128i rkey = k[round];
+            b0 = _mm_aesdec_si128(b0, rkey);
+            b1 = _mm_aesdec_si128(b1, rkey);
+            b2 = _mm_aesdec_si128(b2, rkey);
+            b3 = _mm_aesdec_si128(b3, rkey);
+            b4 = _mm_aesdec_si128(b4, rkey);
+            b5 = _mm_aesdec_si128(b5, rkey);
+            b6 = _mm_aesdec_si128(b6, rkey);
+            b7 = _mm_aesdec_si128(b7, rkey);
+        }
+        __m128i rkey = k[Nr];
+        _mm_storeu_si128(dst + i, _mm_aesdeclast_si128(b0, rkey));
+        _mm_storeu_si128(dst + i + 1, _mm_aesdeclast_si128(b1, rkey));
+        _mm_storeu_si128(dst + i + 2, _mm_aesdeclast_si128(b2, rkey));
+        _mm_storeu_si128(dst + i + 3, _mm_aesdeclast_si128(b3, rkey));
+        _mm_storeu_si128(dst + i + 4, _mm_aesdeclast_si128(b4, rkey));
+        _mm_storeu_si128(dst + i + 5, _mm_aesdeclast_si128(b5, rkey));
+        _mm_storeu_si128(dst + i + 6, _mm_aesdeclast_si128(b6, rkey));
+        _mm_storeu_si128(dst + i + 7, _mm_aesdeclast_si128(b7, rkey));
+    }
+
+    for (; i < n; i++) {
+        aesniDecryptBlock(in + i * 16, out + i * 16, rk, Nr);
+    }
+}
+
+// 64λֽת
+inline uint64_t byteSwap64(uint64_t v) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+// ڼĴй˼飬дڴȡɵĴ洢תͣ
+AESNI_TARGET inline __m128i aesniCounterBlock(uint64_t& hi, uint64_t& lo) {
+    __m128i block = _mm_set_epi64x((long long)byteSwap64(lo), (long long)byteSwap64(hi));
+    if (++lo == 0) {
+        ++hi;
+    }
+    return block;
+}
+
+// nCTRԿ飬(hi, lo)֮
+AESNI_TARGET void aesniCtrKeystream(uint64_t& hi, uint64_t& lo, uint8_t* out, size_t n, const uint8_t* rk, int Nr) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(rk);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    size_t i = 0;
+
+    for (; i + AESNI_LANES <= n; i += AESNI_LANES) {
+        __m128i b0 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b1 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b2 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b3 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b4 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b5 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b6 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        __m128i b7 = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        for (int round = 1; round < Nr; round++) {
+            __m128i rkey = k[round];
+            b0 = _mm_aesenc_si128(b0, rkey);
+            b1 = _mm_aesenc_si128(b1, rkey);
+            b2 = _mm_aesenc_si128(b2, rkey);
+            b3 = _mm_aesenc_si128(b3, rkey);
+            b4 = _mm_aesenc_si128(b4, rkey);
+            b5 = _mm_aesenc_si128(b5, rkey);
+            b6 = _mm_aesenc_si128(b6, rkey);
+            b7 = _mm_aesenc_si128(b7, rkey);
+        }
+        __m128i rkey = k[Nr];
+        _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b0, rkey));
+        _mm_storeu_si128(dst + i + 1, _mm_aesenclast_si128(b1, rkey));
+        _mm_storeu_si128(dst + i + 2, _mm_aesenclast_si128(b2, rkey));
+        _mm_storeu_si128(dst + i + 3, _mm_aesenclast_si128(b3, rkey));
+        _mm_storeu_si128(dst + i + 4, _mm_aesenclast_si128(b4, rkey));
+        _mm_storeu_si128(dst + i + 5, _mm_aesenclast_si128(b5, rkey));
+        _mm_storeu_si128(dst + i + 6, _mm_aesenclast_si128(b6, rkey));
+        _mm_storeu_si128(dst + i + 7, _mm_aesenclast_si128(b7, rkey));
+    }
+
+    for (; i < n; i++) {
+        __m128i b = _mm_xor_si128(aesniCounterBlock(hi, lo), k[0]);
+        for (int round = 1; round < Nr; round++) {
+            b = _mm_aesenc_si128(b, k[round]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b, k[Nr]));
+    }
+}
+#else
+bool cpuHasAESNI() {
+    return false;
+}
+
+bool cpuHasPCLMUL() {
+    return false;
+}
+#endif
+
+// ԶѡĺˣAES-NIʹT
+AESBackend resolveBackend(AESBackend backend) {
+    if (backend == BACKEND_AUTO) {
+        return cpuHasAESNI() ? BACKEND_AESNI : BACKEND_TTABLE;
+    }
+    if (backend == BACKEND_AESNI && !cpuHasAESNI()) {
+        throw runtime_error("ǰCPUĿ겻֧AES-NI");
+    }
+    return backend;
+}
+
+// 
+const char* backendName(AESBackend backend) {
+    switch (backend) {
+    case BACKEND_PORTABLE: return "portable";
+    case BACKEND_TTABLE: return "ttable";
+    case BACKEND_BITSLICE: return "bitslice";
+    case BACKEND_AESNI: return "aesni";
+    default: return "auto";
+    }
+}
+
+// չԿԤ
+Context::Context(const uint8_t* rawKey, KeyLength keyLength, AESBackend requested)
+    : keyLen(keyLength), rounds(ROUNDS[keyLength]), backend(resolveBackend(requested)) {
+#if AES_HAVE_AESNI
+    if (backend == BACKEND_AESNI) {
+        aesniKeyExpansion(rawKey, niEk, keyLen);
+        aesniKeyScheduleDecrypt(niEk, niDk, rounds);
+        return;
+    }
+#endif
+
+    if (backend == BACKEND_BITSLICE) {
+        // ԿչͬʹSе·ⰴԿֽڲ
+        keyExpansion(rawKey, w, keyLen, subWordBitslice);
+        bitsliceKeySchedule(w, bsRk, rounds);
+        return;
+    }
+
+    keyExpansion(rawKey, w, keyLen);
+    if (backend == BACKEND_TTABLE) {
+        keyScheduleEncrypt(w, ek, keyLen);
+        keyScheduleDecrypt(ek, dk, keyLen);
+    }
+}
+
+// ѡ˼һ飨inoutͬ
+void encryptBlock(const uint8_t* in, uint8_t* out, const Context& key) {
+    switch (key.backend) {
+#if AES_HAVE_AESNI
+    case BACKEND_AESNI:
+        aesniEncryptBlock(in, out, key.niEk, key.rounds);
+        break;
+#endif
+    case BACKEND_TTABLE:
+        aesEncryptBlockTTable(in, out, key.ek, key.rounds);
+        break;
+    case BACKEND_BITSLICE:
+        bitsliceCryptBlocks(in, out, 1, key.bsRk, key.rounds, true);
+        break;
+    default:
+        if (in != out) {
+            memcpy(out, in, 16);
+        }
+        aesEncryptBlock(out, key.w, key.keyLen);
+        break;
+    }
+}
+
+// ѡ˽һ飨inoutͬ
+void decryptBlock(const uint8_t* in, uint8_t* out, const Context& key) {
+    switch (key.backend) {
+#if AES_HAVE_AESNI
+    case BACKEND_AESNI:
+        aesniDecryptBlock(in, out, key.niDk, key.rounds);
+        break;
+#endif
+    case BACKEND_TTABLE:
+        aesDecryptBlockTTable(in, out, key.dk, key.rounds);
+        break;
+    case BACKEND_BITSLICE:
+        bitsliceCryptBlocks(in, out, 1, key.bsRk, key.rounds, false);
+        break;
+    default:
+        if (in != out) {
+            memcpy(out, in, 16);
+        }
+        aesDecryptBlock(out, key.w, key.keyLen);
+        break;
+    }
+}
+
+// n໥Ŀ飬֧ˮߵĺһδ
+void encryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const Context& key) {
+#if AES_HAVE_AESNI
+    if (key.backend == BACKEND_AESNI) {
+        aesniEncryptBlocks(in, out, n, key.niEk, key.rounds);
+        return;
+    }
+#endif
+    if (key.backend == BACKEND_BITSLICE) {
+        bitsliceCryptBlocks(in, out, n, key.bsRk, key.rounds, true);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        encryptBlock(in + i * 16, out + i * 16, key);
+    }
+}
+
+// nCTRԿ飬(hi, lo)Ϊ128λĸߵ64λ֮
+void ctrKeystream(uint64_t& hi, uint64_t& lo, uint8_t* out, size_t n, const Context& key) {
+#if AES_HAVE_AESNI
+    if (key.backend == BACKEND_AESNI) {
+        aesniCtrKeystream(hi, lo, out, n, key.niEk, key.rounds);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        storeBE64(out + i * 16, hi);
+        storeBE64(out + i * 16 + 8, lo);
+        if (++lo == 0) {
+            ++hi;
+        }
+    }
+    encryptBlocks(out, out, n, key);
+}
+
+// n໥Ŀ
+void decryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const Context& key) {
+#if AES_HAVE_AESNI
+    if (key.backend == BACKEND_AESNI) {
+        aesniDecryptBlocks(in, out, n, key.niDk, key.rounds);
+        return;
+    }
+#endif
+    if (key.backend == BACKEND_BITSLICE) {
+        bitsliceCryptBlocks(in, out, n, key.bsRk, key.rounds, false);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        decryptBlock(in + i * 16, out + i * 16, key);
+    }
+}
+
+void Context::encrypt_blocks(const uint8_t* in, uint8_t* out, size_t n) const {
+    encryptBlocks(in, out, n, *this);
+}
+
+void Context::decrypt_blocks(const uint8_t* in, uint8_t* out, size_t n) const {
+    decryptBlocks(in, out, n, *this);
+}
+
+// PKCS#7䣺ֻһݣΪ0ֽڣƵblock룬
+// ǰֱӴԭݴ롣鲿ֵֽ
+size_t padFinalBlock(const vector<uint8_t>& data, uint8_t* block) {
+    size_t full = data.size() / 16 * 16;
+    size_t rest = data.size() - full;
+    memcpy(block, data.data() + full, rest);
+    memset(block + rest, static_cast<int>(16 - rest), 16 - rest);
+    return full;
+}
+
+// Ƴ䣺һֽںֱӽض̣
+void trimPadding(vector<uint8_t>& data) {
+    if (data.empty()) {
+        return;
+    }
+
+    size_t paddingSize = data.back();
+    if (paddingSize > data.size() || paddingSize > 16) {
+        throw runtime_error("Ч");
+    }
+
+    data.resize(data.size() - paddingSize);
+}
+
+// ÿ˵ĿڵĿ໥ˮߺ˽
+const size_t BATCH_BLOCKS = 64;
+
+// ̴߳ʱÿ16ıɷ棩
+const size_t CHUNK_SIZE = 256 * 1024;
+
+// [0, len)chunkSizeз֣threads̲߳д߳ͨԭӼȡһ
+void forEachChunk(size_t len, int threads, const function<void(size_t, size_t)>& task, size_t chunkSize = CHUNK_SIZE) {
+    size_t chunks = (len + chunkSize - 1) / chunkSize;
+    atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        for (size_t c = next++; c < chunks; c = next++) {
+            size_t offset = c * chunkSize;
+            task(offset, min(chunkSize, len - offset));
+        }
+    };
+
+    size_t workers = min(static_cast<size_t>(max(threads, 1)), chunks);
+    vector<thread> pool;
+    for (size_t t = 1; t < workers; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : pool) {
+        t.join();
+    }
+}
+
+// ECBģʽģn飬ݿ鲢
+void ecbCryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const Context& key, OperationMode mode, int threads) {
+    forEachChunk(n * 16, threads, [&](size_t offset, size_t len) {
+        if (mode == ENCRYPT) {
+            encryptBlocks(in + offset, out + offset, len / 16, key);
+        }
+        else {
+            decryptBlocks(in + offset, out + offset, len / 16, key);
+        }
+    });
+}
+
+// CBCܺģn飬prevΪֵʼΪIV֮
+void cbcEncryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const Context& key, uint8_t* prev) {
+    uint8_t block[16];
+
+    for (size_t i = 0; i < n; i++) {
+        // ǰһ
+        xorBlocks(block, in + i * 16, prev, 16);
+        encryptBlock(block, prev, key);
+        memcpy(out + i * 16, prev, 16);
+    }
+}
+
+// ռÿݿ֮ǰǸĿ飨һݿȡfirst̴߳ȡñݿֵ
+// ԭشin == outʱѱ̸߳ǳĵ
+vector<uint8_t> chunkFeedback(const uint8_t* in, size_t len, const uint8_t* first) {
+    size_t chunks = (len + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    vector<uint8_t> feedback(chunks * 16);
+    for (size_t c = 0; c < chunks; c++) {
+        memcpy(&feedback[c * 16], c == 0 ? first : in + c * CHUNK_SIZE - 16, 16);
+    }
+    return feedback;
+}
+
+// CBCܺģn飬prevΪǰһĿ鲢ΪһĿ飻outinͬ
+void cbcDecryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const Context& key, uint8_t* prev, int threads) {
+    if (n == 0) {
+        return;
+    }
+
+    uint8_t last[16];
+    memcpy(last, in + (n - 1) * 16, 16);
+    vector<uint8_t> feedback = chunkFeedback(in, n * 16, prev);
+
+    // Ľܻˮߴǰһ
+    // ÿȽܵʱд֮ǰԱ
+    forEachChunk(n * 16, threads, [&](size_t offset, size_t len) {
+        uint8_t plain[BATCH_BLOCKS * 16];
+        uint8_t chain[16];
+        memcpy(chain, &feedback[offset / CHUNK_SIZE * 16], 16);
+
+        for (size_t i = 0; i < len; i += sizeof(plain)) {
+            size_t pos = offset + i;
+            size_t m = min(sizeof(plain), len - i);
+            decryptBlocks(in + pos, plain, m / 16, key);
+
+            xorBytes(plain, chain, 16);
+            xorBytes(plain + 16, in + pos, m - 16);
+            memcpy(chain, in + pos + m - 16, 16);
+            memcpy(out + pos, plain, m);
+        }
+    });
+
+    memcpy(prev, last, 16);
+}
+
+// CFB-8ģÿֽڵһηܣλĴֽڣ
+void cfb8Crypt(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* registerValue, OperationMode mode) {
+    uint8_t encryptedReg[16];
+
+    // ֽڴ
+    for (size_t i = 0; i < len; i++) {
+        uint8_t byte = in[i];
+
+        // ܼĴ
+        encryptBlock(registerValue, encryptedReg, key);
+
+        // ȡܽĵһֽֽ
+        uint8_t outputByte = byte ^ encryptedReg[0];
+        out[i] = outputByte;
+
+        // λĴʱΪģʱΪģ
+        memmove(registerValue, registerValue + 1, 15);
+        registerValue[15] = (mode == ENCRYPT) ? outputByte : byte;
+    }
+}
+
+// CFB-128ܺģÿԿΪǰһĿļֻܽ˳һԲ
+void cfb128EncryptCore(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* registerValue) {
+    for (size_t i = 0; i < len; i += 16) {
+        size_t n = min(static_cast<size_t>(16), len - i);
+        encryptBlock(registerValue, registerValue, key);
+        xorBlocks(out + i, in + i, registerValue, n);
+        memcpy(registerValue, out + i, n);
+    }
+}
+
+// CFB-128ܺģԿֻ֪ģɰˮߴ̲߳Уoutinͬ
+void cfb128DecryptCore(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* registerValue, int threads) {
+    uint8_t next[16];
+    if (len >= 16) {
+        memcpy(next, in + (len / 16 - 1) * 16, 16);
+    }
+    vector<uint8_t> feedback = chunkFeedback(in, len, registerValue);
+
+    forEachChunk(len, threads, [&](size_t offset, size_t chunkLen) {
+        uint8_t keystream[BATCH_BLOCKS * 16];
+        uint8_t prevCipher[16];
+        memcpy(prevCipher, &feedback[offset / CHUNK_SIZE * 16], 16);
+
+        for (size_t i = 0; i < chunkLen; i += sizeof(keystream)) {
+            size_t pos = offset + i;
+            size_t n = min(sizeof(keystream), chunkLen - i);
+            size_t blocks = (n + 15) / 16;
+
+            // һķΪһһĿ飬ķΪڵǰһĿ
+            encryptBlock(prevCipher, keystream, key);
+            encryptBlocks(in + pos, keystream + 16, blocks - 1, key);
+            if (i + n < chunkLen) {
+                memcpy(prevCipher, in + pos + n - 16, 16);
+            }
+
+            xorBlocks(out + pos, in + pos, keystream, n);
+        }
+    });
+
+    if (len >= 16) {
+        memcpy(registerValue, next, 16);
+    }
+}
+
+// OFB-8ģÿֽڵһηܣ
+void ofb8Crypt(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* registerValue) {
+    // ֽڴ
+    for (size_t i = 0; i < len; i++) {
+        // ܼĴ
+        encryptBlock(registerValue, registerValue, key);
+
+        // ȡܽĵһֽֽ
+        out[i] = in[i] ^ registerValue[0];
+    }
+}
+
+// OFB-128ģÿηܲ16ֽԿ
+void ofb128Crypt(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* registerValue) {
+    for (size_t i = 0; i < len; i += 16) {
+        size_t n = min(static_cast<size_t>(16), len - i);
+        encryptBlock(registerValue, registerValue, key);
+        xorBlocks(out + i, in + i, registerValue, n);
+    }
+}
+
+// OFBlenֽڣpositionΪǰѴֽ֮¡ֶδ
+// ÿͰѵʱļĴֵص
+void ofbCryptTracked(const uint8_t* in, uint8_t* out, size_t len, const Context& key, int segment,
+    uint8_t* registerValue, uint64_t& position, const OfbCheckpoint& checkpoint) {
+    while (len > 0) {
+        size_t n = len;
+        if (checkpoint.interval != 0) {
+            n = static_cast<size_t>(min<uint64_t>(len, checkpoint.interval - position % checkpoint.interval));
+        }
+        if (segment == 8) {
+            ofb8Crypt(in, out, n, key, registerValue);
+        }
+        else {
+            ofb128Crypt(in, out, n, key, registerValue);
+        }
+        in += n;
+        out += n;
+        len -= n;
+        position += n;
+        if (checkpoint.interval != 0 && position % checkpoint.interval == 0) {
+            checkpoint.callback(position, registerValue);
+        }
+    }
+}
+
+// CTRģʽģlenֽڣcounterΪһҪʹõļ鲢֮
+void ctrCrypt(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* counter) {
+    uint8_t keystream[BATCH_BLOCKS * 16];
+
+    // 64λ64λʱ64λλ
+    uint64_t hi = loadBE64(counter);
+    uint64_t lo = loadBE64(counter + 8);
+
+    // һһԿ
+    for (size_t i = 0; i < len; i += sizeof(keystream)) {
+        size_t chunk = min(sizeof(keystream), len - i);
+        ctrKeystream(hi, lo, keystream, (chunk + 15) / 16, key);
+
+        // Կ
+        xorBlocks(out + i, in + i, keystream, chunk);
+    }
+
+    storeBE64(counter, hi);
+    storeBE64(counter + 8, lo);
+}
+
+// blocks128λӷ
+void addCounter(uint8_t* counter, uint64_t blocks) {
+    uint64_t hi = loadBE64(counter);
+    uint64_t lo = loadBE64(counter + 8);
+    uint64_t sum = lo + blocks;
+    if (sum < lo) {
+        ++hi;
+    }
+    storeBE64(counter, hi);
+    storeBE64(counter + 8, sum);
+}
+
+// ߳CTRÿݿʼ = counter + ݿ֮ǰĿ
+void ctrCryptParallel(const uint8_t* in, uint8_t* out, size_t len, const Context& key, uint8_t* counter, int threads) {
+    forEachChunk(len, threads, [&](size_t offset, size_t chunkLen) {
+        uint8_t chunkCounter[16];
+        memcpy(chunkCounter, counter, 16);
+        addCounter(chunkCounter, offset / 16);
+        ctrCrypt(in + offset, out + offset, chunkLen, key, chunkCounter);
+    });
+    addCounter(counter, (len + 15) / 16);
+}
+
+// GCM֤ǩ
+const size_t GCM_TAG_SIZE = 16;
+
+// GF(2^128)Լʽ x^128 + x^7 + x^2 + x + 1 GCMλλΪx^0µıʾ
+const uint64_t GHASH_R = 0xE100000000000000ULL;
+
+// 4λԼۼֵ4λʱƳ4λԼ򵽸64λֵ
+struct GHashRemTable {
+    uint64_t r[16];
+};
+
+constexpr GHashRemTable makeGHashRemTable() {
+    GHashRemTable table = {};
+    for (unsigned rem = 0; rem < 16; rem++) {
+        // λ4ΣÿƳһ1һԼʽ
+        uint64_t hi = 0;
+        uint64_t lo = rem;
+        for (int i = 0; i < 4; i++) {
+            uint64_t carry = lo & 1;
+            lo = (lo >> 1) | (hi << 63);
+            hi = (hi >> 1) ^ (carry ? GHASH_R : 0);
+        }
+        table.r[rem] = hi;
+    }
+    return table;
+}
+
+constexpr GHashRemTable GHASH_REM = makeGHashRemTable();
+
+// GCM״̬GHASHԿHԤGHASHۼֵѴ
+struct GCMContext {
+    uint64_t tableHi[16];             // 4λHÿ4λʽĳ˻
+    uint64_t tableLo[16];
+    alignas(16) uint8_t hpow[8][16];  // PCLMULH^1..H^8ֽڷ
+    bool clmul;                       // ʹPCLMULAES-NIƴӴ
+    uint8_t x[16];                    // GHASHۼֵ
+    uint8_t j0[16];                   // ʼ飬ڼ֤ǩ
+    uint64_t ctrHi, ctrLo;            // һ
+    uint64_t aadLen;                  // ֤ݳȣֽڣ
+    uint64_t dataLen;                 // Ѽӽܵݳȣֽڣ
+};
+
+// xGCMλΪһλƳλԼʽۻ
+inline void ghashMulX(uint64_t& hi, uint64_t& lo) {
+    uint64_t carry = lo & 1;
+    lo = (lo >> 1) | (hi << 63);
+    hi = (hi >> 1) ^ (GHASH_R & (0 - carry));
+}
+
+// 4λShoupHߴε4λʼɷÿx^4ϲ
+void ghashMulTable(uint64_t& xHi, uint64_t& xLo, const GCMContext& ctx) {
+    uint64_t zHi = 0;
+    uint64_t zLo = 0;
+    uint64_t words[2] = { xLo, xHi };
+
+    for (int w = 0; w < 2; w++) {
+        for (int shift = 0; shift < 64; shift += 4) {
+            // ÿֽڵĵ4λϸߣڸ4λ
+            unsigned nibble = static_cast<unsigned>(words[w] >> shift) & 0xf;
+            uint64_t rem = zLo & 0xf;
+            zLo = (zLo >> 4) | (zHi << 60);
+            zHi = (zHi >> 4) ^ GHASH_REM.r[rem];
+            zHi ^= ctx.tableHi[nibble];
+            zLo ^= ctx.tableLo[nibble];
+        }
+    }
+
+    xHi = zHi;
+    xLo = zLo;
+}
+
+#if AES_HAVE_AESNI
+// 巭ת16ֽڣPCLMULͨλˣGCMĿ鷭תֽںټ
+CLMUL_TARGET inline __m128i clmulByteSwap(__m128i x) {
+    return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+// ޽λ˷ۼӵδԼ256λ͡С֣˻ֻԼһ
+CLMUL_TARGET inline void clmulMulAcc(__m128i a, __m128i b, __m128i& lo, __m128i& mid, __m128i& hi) {
+    lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+    hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x10));
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x01));
+}
+
+// ϲмһλλ򣩣ٶԼʽȡģ
+CLMUL_TARGET inline __m128i clmulReduce(__m128i lo, __m128i mid, __m128i hi) {
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    __m128i carryLo = _mm_srli_epi32(lo, 31);
+    __m128i carryHi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i cross = _mm_srli_si128(carryLo, 12);
+    carryHi = _mm_slli_si128(carryHi, 4);
+    carryLo = _mm_slli_si128(carryLo, 4);
+    lo = _mm_or_si128(lo, carryLo);
+    hi = _mm_or_si128(hi, carryHi);
+    hi = _mm_or_si128(hi, cross);
+
+    __m128i a = _mm_slli_epi32(lo, 31);
+    __m128i b = _mm_slli_epi32(lo, 30);
+    __m128i c = _mm_slli_epi32(lo, 25);
+    a = _mm_xor_si128(a, b);
+    a = _mm_xor_si128(a, c);
+    b = _mm_srli_si128(a, 4);
+    a = _mm_slli_si128(a, 12);
+    lo = _mm_xor_si128(lo, a);
+
+    __m128i d = _mm_srli_epi32(lo, 1);
+    __m128i e = _mm_srli_epi32(lo, 2);
+    __m128i f = _mm_srli_epi32(lo, 7);
+    d = _mm_xor_si128(d, e);
+    d = _mm_xor_si128(d, f);
+    d = _mm_xor_si128(d, b);
+    lo = _mm_xor_si128(lo, d);
+    return _mm_xor_si128(hi, lo);
+}
+
+CLMUL_TARGET inline __m128i clmulMul(__m128i a, __m128i b) {
+    __m128i lo = _mm_setzero_si128();
+    __m128i mid = _mm_setzero_si128();
+    __m128i hi = _mm_setzero_si128();
+    clmulMulAcc(a, b, lo, mid, hi);
+    return clmulReduce(lo, mid, hi);
+}
+
+// ԤH^1..H^88ۺԼʹ
+CLMUL_TARGET void clmulInit(const uint8_t* h, uint8_t (*hpow)[16]) {
+    __m128i h1 = clmulByteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h)));
+    __m128i p = h1;
+    for (int i = 0; i < 8; i++) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(hpow[i]), p);
+        p = clmulMul(p, h1);
+    }
+}
+
+// nGHASHÿ8H^8..H^1ֱ˺ۼӣֻԼһ
+CLMUL_TARGET void clmulGhash(uint8_t* x, const uint8_t* data, size_t n, const uint8_t (*hpow)[16]) {
+    const __m128i* hp = reinterpret_cast<const __m128i*>(hpow);
+    const __m128i* src = reinterpret_cast<const __m128i*>(data);
+    __m128i acc = clmulByteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i mid = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        clmulMulAcc(_mm_xor_si128(acc, clmulByteSwap(_mm_loadu_si128(src + i))), hp[7], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 1)), hp[6], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 2)), hp[5], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 3)), hp[4], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 4)), hp[3], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 5)), hp[2], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 6)), hp[1], lo, mid, hi);
+        clmulMulAcc(clmulByteSwap(_mm_loadu_si128(src + i + 7)), hp[0], lo, mid, hi);
+        acc = clmulReduce(lo, mid, hi);
+    }
+
+    for (; i < n; i++) {
+        acc = clmulMul(_mm_xor_si128(acc, clmulByteSwap(_mm_loadu_si128(src + i))), hp[0]);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(x), clmulByteSwap(acc));
+}
+
+// 8ͬʱִһAESENC
+CLMUL_TARGET inline void aesniEncRound8(__m128i& b0, __m128i& b1, __m128i& b2, __m128i& b3,
+    __m128i& b4, __m128i& b5, __m128i& b6, __m128i& b7, __m128i rkey) {
+    b0 = _mm_aesenc_si128(b0, rkey);
+    b1 = _mm_aesenc_si128(b1, rkey);
+    b2 = _mm_aesenc_si128(b2, rkey);
+    b3 = _mm_aesenc_si128(b3, rkey);
+    b4 = _mm_aesenc_si128(b4, rkey);
+    b5 = _mm_aesenc_si128(b5, rkey);
+    b6 = _mm_aesenc_si128(b6, rkey);
+    b7 = _mm_aesenc_si128(b7, rkey);
+}
+
+// CTRGHASHƴӣÿ8飬ǰ8AESENC֮һPCLMUL˷ָڲִͬж˿ϲС
+// ʱԱGHASHʱδһGHASHѭһ
+// ֻ8ΣشĿ(hi, lo)֮
+CLMUL_TARGET size_t clmulGcmCrypt(const uint8_t* in, uint8_t* out, size_t n, const uint8_t* rk, int Nr,
+    uint64_t& ctrHi, uint64_t& ctrLo, const uint8_t (*hpow)[16], uint8_t* x, bool encrypt) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(rk);
+    const __m128i* hp = reinterpret_cast<const __m128i*>(hpow);
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    __m128i acc = clmulByteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    size_t i = 0;
+
+    for (; i + AESNI_LANES <= n; i += AESNI_LANES) {
+        __m128i b0 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b1 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b2 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b3 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b4 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b5 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b6 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+        __m128i b7 = _mm_xor_si128(aesniCounterBlock(ctrHi, ctrLo), k[0]);
+
+        // ҪGHASH8Ŀ
+        const __m128i* hs = encrypt ? (i > 0 ? dst + i - AESNI_LANES : nullptr) : src + i;
+        if (hs != nullptr) {
+            __m128i lo = _mm_setzero_si128();
+            __m128i mid = _mm_setzero_si128();
+            __m128i hi = _mm_setzero_si128();
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[1]);
+            clmulMulAcc(_mm_xor_si128(acc, clmulByteSwap(_mm_loadu_si128(hs))), hp[7], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[2]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 1)), hp[6], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[3]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 2)), hp[5], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[4]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 3)), hp[4], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[5]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 4)), hp[3], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[6]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 5)), hp[2], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[7]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 6)), hp[1], lo, mid, hi);
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[8]);
+            clmulMulAcc(clmulByteSwap(_mm_loadu_si128(hs + 7)), hp[0], lo, mid, hi);
+            acc = clmulReduce(lo, mid, hi);
+        }
+        else {
+            for (int round = 1; round <= 8; round++) {
+                aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[round]);
+            }
+        }
+        for (int round = 9; round < Nr; round++) {
+            aesniEncRound8(b0, b1, b2, b3, b4, b5, b6, b7, k[round]);
+        }
+
+        // Կÿȶдԭش
+        __m128i rkey = k[Nr];
+        _mm_storeu_si128(dst + i, _mm_xor_si128(_mm_aesenclast_si128(b0, rkey), _mm_loadu_si128(src + i)));
+        _mm_storeu_si128(dst + i + 1, _mm_xor_si128(_mm_aesenclast_si128(b1, rkey), _mm_loadu_si128(src + i + 1)));
+        _mm_storeu_si128(dst + i + 2, _mm_xor_si128(_mm_aesenclast_si128(b2, rkey), _mm_loadu_si128(src + i + 2)));
+        _mm_storeu_si128(dst + i + 3, _mm_xor_si128(_mm_aesenclast_si128(b3, rkey), _mm_loadu_si128(src + i + 3)));
+        _mm_storeu_si128(dst + i + 4, _mm_xor_si128(_mm_aesenclast_si128(b4, rkey), _mm_loadu_si128(src + i + 4)));
+        _mm_storeu_si128(dst + i + 5, _mm_xor_si128(_mm_aesenclast_si128(b5, rkey), _mm_loadu_si128(src + i + 5)));
+        _mm_storeu_si128(dst + i + 6, _mm_xor_si128(_mm_aesenclast_si128(b6, rkey), _mm_loadu_si128(src + i + 6)));
+        _mm_storeu_si128(dst + i + 7, _mm_xor_si128(_mm_aesenclast_si128(b7, rkey), _mm_loadu_si128(src + i + 7)));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(x), clmulByteSwap(acc));
+
+    // ʱһĻûмGHASH
+    if (encrypt && i > 0) {
+        clmulGhash(x, out + (i - AESNI_LANES) * 16, AESNI_LANES, hpow);
+    }
+    return i;
+}
+#endif
+
+// GHASHn鲢ۼֵ
+void ghashBlocks(GCMContext& ctx, const uint8_t* data, size_t n) {
+#if AES_HAVE_AESNI
+    if (ctx.clmul) {
+        clmulGhash(ctx.x, data, n, ctx.hpow);
+        return;
+    }
+#endif
+    uint64_t hi = loadBE64(ctx.x);
+    uint64_t lo = loadBE64(ctx.x + 8);
+    for (size_t i = 0; i < n; i++) {
+        hi ^= loadBE64(data + i * 16);
+        lo ^= loadBE64(data + i * 16 + 8);
+        ghashMulTable(hi, lo, ctx);
+    }
+    storeBE64(ctx.x, hi);
+    storeBE64(ctx.x + 8, lo);
+}
+
+// GHASHlenֽڲۼֵһ鲹㣨ֻܳڸݻĵĩβ
+void ghashUpdate(GCMContext& ctx, const uint8_t* data, size_t len) {
+    size_t full = len / 16;
+    ghashBlocks(ctx, data, full);
+
+    size_t rest = len - full * 16;
+    if (rest > 0) {
+        uint8_t block[16] = {};
+        memcpy(block, data + full * 16, rest);
+        ghashBlocks(ctx, block, 1);
+    }
+}
+
+// 볤ȿ飺len(A)len(C)ı64λ
+void ghashLengths(GCMContext& ctx, uint64_t aadLen, uint64_t dataLen) {
+    uint8_t block[16];
+    storeBE64(block, aadLen * 8);
+    storeBE64(block + 8, dataLen * 8);
+    ghashUpdate(ctx, block, 16);
+}
+
+// ʼGCMH = E(K, 0)IVõJ0inc32(J0)ʼ֤
+void gcmInit(GCMContext& ctx, const Context& key, const uint8_t* iv, size_t ivLen, const uint8_t* aad, size_t aadLen) {
+    uint8_t h[16] = {};
+    encryptBlock(h, h, key);
+
+    // 4λtable[8] = Htable[4] = Hxtable[2] = Hx^2table[1] = Hx^3Ϊ
+    uint64_t hHi = loadBE64(h);
+    uint64_t hLo = loadBE64(h + 8);
+    ctx.tableHi[0] = 0;
+    ctx.tableLo[0] = 0;
+    for (int i = 8; i > 0; i >>= 1) {
+        ctx.tableHi[i] = hHi;
+        ctx.tableLo[i] = hLo;
+        ghashMulX(hHi, hLo);
+    }
+    for (int i = 2; i < 16; i <<= 1) {
+        for (int j = 1; j < i; j++) {
+            ctx.tableHi[i + j] = ctx.tableHi[i] ^ ctx.tableHi[j];
+            ctx.tableLo[i + j] = ctx.tableLo[i] ^ ctx.tableLo[j];
+        }
+    }
+
+    // ʹAES-NICPU֧PCLMULʱGHASH޽λ˷CTRƴ
+    ctx.clmul = false;
+#if AES_HAVE_AESNI
+    if (key.backend == BACKEND_AESNI && cpuHasPCLMUL()) {
+        ctx.clmul = true;
+        clmulInit(h, ctx.hpow);
+    }
+#endif
+
+    // 96λIVJ0 = IV || 0^31 || 1ȣJ0 = GHASH(IV ||  || ȿ)
+    memset(ctx.x, 0, 16);
+    if (ivLen == 12) {
+        memcpy(ctx.j0, iv, 12);
+        storeBE32(ctx.j0 + 12, 1);
+    }
+    else {
+        ghashUpdate(ctx, iv, ivLen);
+        ghashLengths(ctx, 0, ivLen);
+        memcpy(ctx.j0, ctx.x, 16);
+        memset(ctx.x, 0, 16);
+    }
+
+    // ֻ32λinc32
+    ctx.ctrHi = loadBE64(ctx.j0);
+    ctx.ctrLo = loadBE64(ctx.j0 + 8);
+    ctx.ctrLo = (ctx.ctrLo & 0xFFFFFFFF00000000ULL) | ((ctx.ctrLo + 1) & 0xFFFFFFFFULL);
+
+    ctx.aadLen = aadLen;
+    ctx.dataLen = 0;
+    ghashUpdate(ctx, aad, aadLen);
+}
+
+// GCMӽܣCTRܵͬʱGHASHֻһεõlenԲ16ı
+void gcmCrypt(GCMContext& ctx, const Context& key, const uint8_t* in, uint8_t* out, size_t len, OperationMode mode) {
+    uint8_t keystream[BATCH_BLOCKS * 16];
+    ctx.dataLen += len;
+
+    while (len > 0) {
+        // inc32ֻڵ32λڻƣƵֶΣÿڿʹ128λ
+        uint64_t untilWrap = 0x100000000ULL - (ctx.ctrLo & 0xFFFFFFFFULL);
+        size_t segment = static_cast<size_t>(min(static_cast<uint64_t>(len), untilWrap * 16));
+        uint64_t ctrHi = ctx.ctrHi;
+        uint64_t ctrUpper = ctx.ctrLo & 0xFFFFFFFF00000000ULL;
+        size_t done = 0;
+
+#if AES_HAVE_AESNI
+        if (ctx.clmul) {
+            done = clmulGcmCrypt(in, out, segment / 16, key.niEk, key.rounds,
+                ctx.ctrHi, ctx.ctrLo, ctx.hpow, ctx.x, mode == ENCRYPT) * 16;
+        }
+#endif
+
+        for (size_t i = done; i < segment; i += sizeof(keystream)) {
+            size_t n = min(sizeof(keystream), segment - i);
+            ctrKeystream(ctx.ctrHi, ctx.ctrLo, keystream, (n + 15) / 16, key);
+
+            // GHASHģʱڸ֮ǰ
+            if (mode == DECRYPT) {
+                ghashUpdate(ctx, in + i, n);
+            }
+            xorBlocks(out + i, in + i, keystream, n);
+            if (mode == ENCRYPT) {
+                ghashUpdate(ctx, out + i, n);
+            }
+        }
+
+        // 32λһֺƵ0λλ
+        if (segment == untilWrap * 16) {
+            ctx.ctrHi = ctrHi;
+            ctx.ctrLo = ctrUpper;
+        }
+
+        in += segment;
+        out += segment;
+        len -= segment;
+    }
+}
+
+// ֤ǩT = E(K, J0) ^ GHASH(A, C)
+void gcmTag(GCMContext& ctx, const Context& key, uint8_t* tag) {
+    ghashLengths(ctx, ctx.aadLen, ctx.dataLen);
+    encryptBlock(ctx.j0, tag, key);
+    xorBytes(tag, ctx.x, 16);
+}
+
+// ʱȽϣͨȽϺʱֽڲ³ȷıǩ
+bool constantTimeEqual(const uint8_t* a, const uint8_t* b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+// ECBģʽ
+vector<uint8_t> ecbEncrypt(const vector<uint8_t>& data, const Context& key, int threads) {
+    uint8_t last[16];
+    size_t full = padFinalBlock(data, last);
+    vector<uint8_t> result(full + 16);
+
+    // 黥ݿ齻˲дԤȷĽһ鵥
+    ecbCryptBlocks(data.data(), result.data(), full / 16, key, ENCRYPT, threads);
+    encryptBlock(last, result.data() + full, key);
+
+    return result;
+}
+
+// ECBģʽ
+vector<uint8_t> ecbDecrypt(const vector<uint8_t>& data, const Context& key, int threads) {
+    if (data.size() % 16 != 0) {
+        throw runtime_error("ݳȱ16ı");
+    }
+
+    vector<uint8_t> result(data.size());
+    ecbCryptBlocks(data.data(), result.data(), data.size() / 16, key, DECRYPT, threads);
+
+    // Ƴ
+    trimPadding(result);
+    return result;
+}
+
+// CBCģʽ
+vector<uint8_t> cbcEncrypt(const vector<uint8_t>& data, const Context& key, const uint8_t* iv) {
+    uint8_t last[16];
+    size_t full = padFinalBlock(data, last);
+    vector<uint8_t> result(full + 16);
+
+    uint8_t prevBlock[16];
+    memcpy(prevBlock, iv, 16);
+    cbcEncryptBlocks(data.data(), result.data(), full / 16, key, prevBlock);
+    cbcEncryptBlocks(last, result.data() + full, 1, key, prevBlock);
+
+    return result;
+}
+
+// CBCģʽ
+vector<uint8_t> cbcDecrypt(const vector<uint8_t>& data, const Context& key, const uint8_t* iv, int threads) {
+    if (data.size() % 16 != 0) {
+        throw runtime_error("ݳȱ16ı");
+    }
+
+    vector<uint8_t> result(data.size());
+
+    uint8_t prevBlock[16];
+    memcpy(prevBlock, iv, 16);
+    cbcDecryptBlocks(data.data(), result.data(), data.size() / 16, key, prevBlock, threads);
+
+    // Ƴ
+    trimPadding(result);
+    return result;
+}
+
+// CFB-8ģʽ
+vector<uint8_t> cfbProcess(const vector<uint8_t>& data, const Context& key, const uint8_t* iv, OperationMode mode) {
+    vector<uint8_t> result(data.size());
+
+    uint8_t registerValue[16];
+    memcpy(registerValue, iv, 16);
+    cfb8Crypt(data.data(), result.data(), data.size(), key, registerValue, mode);
+
+    return result;
+}
+
+// CFB-128ģʽ
+vector<uint8_t> cfb128Encrypt(const vector<uint8_t>& data, const Context& key, const uint8_t* iv) {
+    vector<uint8_t> result(data.size());
+
+    uint8_t registerValue[16];
+    memcpy(registerValue, iv, 16);
+    cfb128EncryptCore(data.data(), result.data(), data.size(), key, registerValue);
+
+    return result;
+}
+
+// CFB-128ģʽ
+vector<uint8_t> cfb128Decrypt(const vector<uint8_t>& data, const Context& key, const uint8_t* iv, int threads) {
+    vector<uint8_t> result(data.size());
+
+    uint8_t registerValue[16];
+    memcpy(registerValue, iv, 16);
+    cfb128DecryptCore(data.data(), result.data(), data.size(), key, registerValue, threads);
+
+    return result;
+}
+
+// OFB-8ģʽܺͽͬ
+vector<uint8_t> ofbProcess(const vector<uint8_t>& data, const Context& key, const uint8_t* iv,
+    const OfbCheckpoint& checkpoint = OfbCheckpoint()) {
+    vector<uint8_t> result(data.size());
+
+    uint8_t registerValue[16];
+    memcpy(registerValue, iv, 16);
+    uint64_t position = 0;
+    ofbCryptTracked(data.data(), result.data(), data.size(), key, 8, registerValue, position, checkpoint);
+
+    return result;
+}
+
+// OFB-128ģʽܺͽͬ
+vector<uint8_t> ofb128Process(const vector<uint8_t>& data, const Context& key, const uint8_t* iv,
+    const OfbCheckpoint& checkpoint = OfbCheckpoint()) {
+    vector<uint8_t> result(data.size());
+
+    uint8_t registerValue[16];
+    memcpy(registerValue, iv, 16);
+    uint64_t position = 0;
+    ofbCryptTracked(data.data(), result.data(), data.size(), key, 128, registerValue, position, checkpoint);
+
+    return result;
+}
+
+// CTRģʽܺͽͬ
+vector<uint8_t> ctrProcess(const vector<uint8_t>& data, const Context& key, const uint8_t* iv, int threads) {
+    vector<uint8_t> result(data.size());
+
+    uint8_t counter[16];
+    memcpy(counter, iv, 16);
+    ctrCryptParallel(data.data(), result.data(), data.size(), key, counter, threads);
+
+    return result;
+}
+
+// XTStweakԦС128λһλƳλx^128 = x^7 + x^2 + x + 1ۻ
+inline void xtsMulAlpha(uint64_t& lo, uint64_t& hi) {
+    uint64_t carry = hi >> 63;
+    hi = (hi << 1) | (lo >> 63);
+    lo = (lo << 1) ^ (0x87 & (0 - carry));
+}
+
+// XTSһ飺out = E(in ^ tweak) ^ tweakʱΪD
+void xtsBlock(const uint8_t* in, uint8_t* out, const uint8_t* tweak, const Context& key, OperationMode mode) {
+    uint8_t block[16];
+    xorBlocks(block, in, tweak, 16);
+    if (mode == ENCRYPT) {
+        encryptBlock(block, block, key);
+    }
+    else {
+        decryptBlock(block, block, key);
+    }
+    xorBlocks(out, block, tweak, 16);
+}
+
+// XTSһlen16ֽڣڸtweakγԦȫã
+// ʹһνˮߺˣlen16ıʱŲátweaksΪlenֽڵʱռ
+void xtsCryptSector(const Context& dataKey, const Context& tweakKey, uint64_t sector,
+    const uint8_t* in, uint8_t* out, size_t len, OperationMode mode, uint8_t* tweaks) {
+    size_t rest = len % 16;
+    size_t bulk = len / 16 - (rest ? 1 : 0);
+
+    // ʼtweakΪţСˣõڶԿܵĽ
+    uint8_t t[16];
+    storeLE64(t, sector);
+    storeLE64(t + 8, 0);
+    encryptBlock(t, t, tweakKey);
+    uint64_t lo = loadLE64(t);
+    uint64_t hi = loadLE64(t + 8);
+
+    for (size_t i = 0; i < bulk; i++) {
+        storeLE64(tweaks + i * 16, lo);
+        storeLE64(tweaks + i * 16 + 8, hi);
+        xtsMulAlpha(lo, hi);
+    }
+    xorBlocks(out, in, tweaks, bulk * 16);
+    if (mode == ENCRYPT) {
+        encryptBlocks(out, out, bulk, dataKey);
+    }
+    else {
+        decryptBlocks(out, out, bulk, dataKey);
+    }
+    xorBlocks(out, out, tweaks, bulk * 16);
+    if (rest == 0) {
+        return;
+    }
+
+    // Ųãһ飨tweakΪT[m-1]벻βT[m]һȲ
+    uint8_t prevTweak[16];
+    uint8_t lastTweak[16];
+    storeLE64(prevTweak, lo);
+    storeLE64(prevTweak + 8, hi);
+    xtsMulAlpha(lo, hi);
+    storeLE64(lastTweak, lo);
+    storeLE64(lastTweak + 8, hi);
+
+    const uint8_t* inBlock = in + bulk * 16;
+    uint8_t* outBlock = out + bulk * 16;
+    uint8_t tail[16];
+    uint8_t block[16];
+    memcpy(tail, inBlock + 16, rest);
+    if (mode == ENCRYPT) {
+        // CC = E(P[m-1])C[m] = CCǰrestֽڣC[m-1] = E(P[m] || CCֽ)
+        xtsBlock(inBlock, block, prevTweak, dataKey, ENCRYPT);
+        memcpy(outBlock + 16, block, rest);
+        memcpy(block, tail, rest);
+        xtsBlock(block, outBlock, lastTweak, dataKey, ENCRYPT);
+    }
+    else {
+        // PP = D(C[m-1])P[m] = PPǰrestֽڣP[m-1] = D(C[m] || PPֽ)
+        xtsBlock(inBlock, block, lastTweak, dataKey, DECRYPT);
+        memcpy(outBlock + 16, block, rest);
+        memcpy(block, tail, rest);
+        xtsBlock(block, outBlock, prevTweak, dataKey, DECRYPT);
+    }
+}
+
+// XTSзֺ̲߳дÿɸ
+void xtsCrypt(const Context& dataKey, const Context& tweakKey, uint64_t sector, size_t sectorSize,
+    const uint8_t* in, uint8_t* out, size_t len, OperationMode op, int threads) {
+    if (sectorSize < 16 || sectorSize % 16 != 0) {
+        throw invalid_argument("С16ı");
+    }
+    size_t tailLen = len % sectorSize;
+    if (tailLen != 0 && tailLen < 16) {
+        throw runtime_error("XTSݵһ16ֽ");
+    }
+
+    size_t chunkSize = max<size_t>(1, CHUNK_SIZE / sectorSize) * sectorSize;
+    forEachChunk(len, threads, [&](size_t offset, size_t chunkLen) {
+        vector<uint8_t> tweaks(sectorSize);
+        for (size_t pos = 0; pos < chunkLen; pos += sectorSize) {
+            size_t n = min(sectorSize, chunkLen - pos);
+            xtsCryptSector(dataKey, tweakKey, sector + (offset + pos) / sectorSize,
+                in + offset + pos, out + offset + pos, n, op, tweaks.data());
+        }
+    }, chunkSize);
+}
+
+// CBC/CFB/OFB/CTRĳʼΪһ
+void checkBlockIV(size_t ivLen) {
+    if (ivLen != 16) {
+        throw invalid_argument("ʼȱ16ֽ");
+    }
+}
+
+// ECBʽ
+class ECBStream : public Stream {
+public:
+    ECBStream(const Context& key, OperationMode mode, int threads)
+        : Stream(mode == DECRYPT ? 1 : 0), key(key), mode(mode), threads(threads) {}
+
+protected:
+    void processBlocks(const uint8_t* in, uint8_t* out, size_t n) override {
+        ecbCryptBlocks(in, out, n, key, mode, threads);
+    }
+
+    void restart(const uint8_t*, size_t) override {}
+
+    size_t processTail(const uint8_t* in, size_t len, uint8_t* out) override {
+        uint8_t block[16];
+        if (mode == ENCRYPT) {
+            padBlock(in, len, block);
+            encryptBlock(block, out, key);
+            return 16;
+        }
+        if (len == 0) {
+            return 0;
+        }
+        if (len != 16) {
+            throw runtime_error("ݳȱ16ı");
+        }
+        decryptBlock(in, block, key);
+        size_t n = unpaddedSize(block);
+        memcpy(out, block, n);
+        return n;
+    }
+
+private:
+    const Context& key;
+    OperationMode mode;
+    int threads;
+};
+
+// CBCʽ
+class CBCStream : public Stream {
+public:
+    CBCStream(const Context& key, const uint8_t* iv, size_t ivLen, OperationMode mode, int threads)
+        : Stream(mode == DECRYPT ? 1 : 0), key(key), mode(mode), threads(threads) {
+        restart(iv, ivLen);
+    }
+
+protected:
+    void processBlocks(const uint8_t* in, uint8_t* out, size_t n) override {
+        if (mode == ENCRYPT) {
+            cbcEncryptBlocks(in, out, n, key, prevBlock);
+        }
+        else {
+            cbcDecryptBlocks(in, out, n, key, prevBlock, threads);
+        }
+    }
+
+    size_t processTail(const uint8_t* in, size_t len, uint8_t* out) override {
+        uint8_t block[16];
+        if (mode == ENCRYPT) {
+            padBlock(in, len, block);
+            cbcEncryptBlocks(block, out, 1, key, prevBlock);
+            return 16;
+        }
+        if (len == 0) {
+            return 0;
+        }
+        if (len != 16) {
+            throw runtime_error("ݳȱ16ı");
+        }
+        cbcDecryptBlocks(in, block, 1, key, prevBlock, 1);
+        size_t n = unpaddedSize(block);
+        memcpy(out, block, n);
+        return n;
+    }
+
+    void restart(const uint8_t* iv, size_t ivLen) override {
+        checkBlockIV(ivLen);
+        memcpy(prevBlock, iv, 16);
+    }
+
+private:
+    const Context& key;
+    OperationMode mode;
+    int threads;
+    uint8_t prevBlock[16];
+};
+
+// CFB/OFB/CTRʽһֻʹòԿ
+class KeystreamStream : public Stream {
+public:
+    KeystreamStream(const Context& key, const uint8_t* iv, size_t ivLen, AESMode aesMode, OperationMode mode, int segment, int threads,
+        const OfbCheckpoint& checkpoint)
+        : Stream(0), key(key), aesMode(aesMode), mode(mode), segment(segment), threads(threads), checkpoint(checkpoint) {
+        restart(iv, ivLen);
+    }
+
+protected:
+    void processBlocks(const uint8_t* in, uint8_t* out, size_t n) override {
+        crypt(in, out, n * 16);
+    }
+
+    size_t processTail(const uint8_t* in, size_t len, uint8_t* out) override {
+        crypt(in, out, len);
+        return len;
+    }
+
+    void restart(const uint8_t* iv, size_t ivLen) override {
+        checkBlockIV(ivLen);
+        memcpy(registerValue, iv, 16);
+        position = 0;
+    }
+
+private:
+    void crypt(const uint8_t* in, uint8_t* out, size_t len) {
+        switch (aesMode) {
+        case CFB:
+            if (segment == 8) {
+                cfb8Crypt(in, out, len, key, registerValue, mode);
+            }
+            else if (mode == ENCRYPT) {
+                cfb128EncryptCore(in, out, len, key, registerValue);
+            }
+            else {
+                cfb128DecryptCore(in, out, len, key, registerValue, threads);
+            }
+            break;
+        case OFB:
+            ofbCryptTracked(in, out, len, key, segment, registerValue, position, checkpoint);
+            break;
+        default:
+            ctrCryptParallel(in, out, len, key, registerValue, threads);
+            break;
+        }
+    }
+
+    const Context& key;
+    AESMode aesMode;
+    OperationMode mode;
+    int segment;
+    int threads;
+    OfbCheckpoint checkpoint;
+    uint64_t position;          // OFBѴֽȷλ
+    uint8_t registerValue[16];  // λĴ
+};
+
+// GCMʽΪļ16ֽ֤ǩʱĩβ16ֽΪǩfinishʱУ飬
+// ƥ׳쳣÷趪ģ
+class GCMStream : public Stream {
+public:
+    GCMStream(const Context& key, const uint8_t* iv, size_t ivLen, const string& aad, OperationMode mode)
+        : Stream(mode == DECRYPT ? GCM_TAG_SIZE : 0), key(key), mode(mode), aad(aad) {
+        restart(iv, ivLen);
+    }
+
+protected:
+    void processBlocks(const uint8_t* in, uint8_t* out, size_t n) override {
+        gcmCrypt(ctx, key, in, out, n * 16, mode);
+    }
+
+    size_t processTail(const uint8_t* in, size_t len, uint8_t* out) override {
+        if (mode == ENCRYPT) {
+            gcmCrypt(ctx, key, in, out, len, mode);
+            gcmTag(ctx, key, out + len);
+            return len + GCM_TAG_SIZE;
+        }
+
+        if (len < GCM_TAG_SIZE) {
+            throw runtime_error("̫̣ȱ֤ǩ");
+        }
+        size_t n = len - GCM_TAG_SIZE;
+        gcmCrypt(ctx, key, in, out, n, mode);
+
+        uint8_t tag[GCM_TAG_SIZE];
+        gcmTag(ctx, key, tag);
+        if (!constantTimeEqual(tag, in + n, GCM_TAG_SIZE)) {
+            throw runtime_error("֤ʧܣѱ۸ģԿʼݲȷ");
+        }
+        return n;
+    }
+
+    void restart(const uint8_t* iv, size_t ivLen) override {
+        if (ivLen == 0) {
+            throw invalid_argument("GCMʼΪ");
+        }
+        gcmInit(ctx, key, iv, ivLen, reinterpret_cast<const uint8_t*>(aad.data()), aad.size());
+    }
+
+private:
+    const Context& key;
+    OperationMode mode;
+    string aad;
+    GCMContext ctx;
+};
+
+// GCMģʽһʽ
+vector<uint8_t> gcmProcess(const vector<uint8_t>& data, const Context& key, const string& iv, const string& aad, OperationMode mode) {
+    GCMStream stream(key, reinterpret_cast<const uint8_t*>(iv.data()), iv.size(), aad, mode);
+    vector<uint8_t> result;
+    result.reserve(data.size() + GCM_TAG_SIZE);
+    stream.update(data.data(), data.size(), result);
+    stream.finish(result);
+    return result;
+}
+
+// ģʽʽ
+unique_ptr<Stream> makeStream(const Context& key, AESMode mode, OperationMode op,
+    const uint8_t* iv, size_t ivLen, const StreamOptions& options) {
+    if (options.segment != 8 && options.segment != 128) {
+        throw invalid_argument("ֶγȱ8128");
+    }
+    if (options.checkpoint.interval % 16 != 0) {
+        throw invalid_argument("16ı");
+    }
+    int threads = max(options.threads, 1);
+    switch (mode) {
+    case ECB:
+        return unique_ptr<Stream>(new ECBStream(key, op, threads));
+    case CBC:
+        return unique_ptr<Stream>(new CBCStream(key, iv, ivLen, op, threads));
+    case GCM:
+        return unique_ptr<Stream>(new GCMStream(key, iv, ivLen, options.aad, op));
+    case XTS:
+        throw invalid_argument("XTSģʽʹxtsCrypt");
+    default:
+        return unique_ptr<Stream>(new KeystreamStream(key, iv, ivLen, mode, op, options.segment, threads, options.checkpoint));
+    }
+}
+
+}  // namespace aes
+
+#ifndef AES_NO_MAIN
+
+// ===== й =====
+
+using namespace aes;
+
+// вṹ
+struct Args {
+    OperationMode opMode;
+    AESMode aesMode;
+    KeyLength keyLen;
+    AESBackend backend;
+    int threads;      // ߳
+    int segment;      // CFB/OFBֶγȣλ
+    bool stream;      // ʽ
+    bool mmap;        // ڴӳļ
+    bool inplace;     // ļԭش
+    string key;       // Կ
+    string iv;        // ʼ
+    string aad;       // GCM֤
+    string inputFile;
+    string outputFile;
+    string batchFile;             // 嵥ļ
+    vector<string> inputFiles;    // -fָļ
+    vector<string> outputFiles;   // -oָļ
+    bool batch;                   // ļ
+    size_t sectorSize;            // XTSС
+    uint64_t offset;              // XTSΧھеʼλ
+    uint64_t length;              // XTSΧĳ
+    bool hasRange;                // Ƿָ--offset--length
+    bool hasLength;
+    bool byteRange;               // ֻ--rangeָֽڷΧ
+    uint64_t rangeStart;
+    uint64_t rangeLength;         // UINT64_MAXʾļĩβ
+    string checkpointFile;        // OFBļ
+    uint64_t checkpointInterval;  // ڼֽ֮
+};
+
+// ֧KMG׺1024ƣ
+uint64_t parseSize(const string& text) {
+    size_t pos = 0;
+    unsigned long long value = stoull(text, &pos);
+    string suffix = text.substr(pos);
+    if (suffix == "K" || suffix == "k") value <<= 10;
+    else if (suffix == "M" || suffix == "m") value <<= 20;
+    else if (suffix == "G" || suffix == "g") value <<= 30;
+    else if (!suffix.empty()) throw invalid_argument("Ч: " + text);
+    return value;
+}
+
+// ֤ʼ
+void validateIV(AESMode mode, const string& iv) {
+    if (mode == XTS) {
+        // XTSΪtweakʹóʼ
+        return;
+    }
+    if (mode != ECB && iv.empty()) {
+        throw invalid_argument("CBC/CFB/OFB/CTR/GCMģʽҪʼ");
+    }
+    if (mode == GCM) {
+        if (iv.length() != 12 && iv.length() != 16) {
+            throw invalid_argument("GCMʼ1216ַ");
+        }
+    }
+    else if (!iv.empty() && iv.length() != 16) {
+        throw invalid_argument("ʼ16ַ");
+    }
+}
+
+// в
+Args parseArgs(int argc, char* argv[]) {
+    Args args;
+    args.opMode = ENCRYPT; // Ĭϼ
+    args.aesMode = ECB;    // ĬECBģʽ
+    args.keyLen = AES_128; // Ĭ128λԿ
+    args.backend = BACKEND_AUTO;   // ĬԶѡ
+    args.threads = 1;              // Ĭϵ߳
+    args.segment = 8;              // Ĭ8λֶΣļ
+    args.stream = false;           // Ĭļڴ
+    args.mmap = false;
+    args.inplace = false;
+    args.batch = false;
+    args.sectorSize = 512;
+    args.offset = 0;
+    args.length = 0;
+    args.hasRange = false;
+    args.hasLength = false;
+    args.byteRange = false;
+    args.rangeStart = 0;
+    args.rangeLength = UINT64_MAX;
+    args.checkpointInterval = 1 << 20;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-m" || arg == "--mode") {
+            if (i + 1 >= argc) throw invalid_argument("ȱģʽֵ");
+            string mode = argv[++i];
+            if (mode == "encrypt") args.opMode = ENCRYPT;
+            else if (mode == "decrypt") args.opMode = DECRYPT;
+            else throw invalid_argument("Чģʽ: " + mode);
+        }
+        else if (arg == "-a" || arg == "--aes-mode") {
+            if (i + 1 >= argc) throw invalid_argument("ȱAESģʽֵ");
+            string mode = argv[++i];
+            if (mode == "ecb") args.aesMode = ECB;
+            else if (mode == "cbc") args.aesMode = CBC;
+            else if (mode == "cfb") args.aesMode = CFB;
+            else if (mode == "ofb") args.aesMode = OFB;
+            else if (mode == "ctr") args.aesMode = CTR;
+            else if (mode == "gcm") args.aesMode = GCM;
+            else if (mode == "xts") args.aesMode = XTS;
+            else throw invalid_argument("ЧAESģʽ: " + mode);
+        }
+        else if (arg == "-l" || arg == "--key-length") {
+            if (i + 1 >= argc) throw invalid_argument("ȱԿȲֵ");
+            string len = argv[++i];
+            if (len == "128") args.keyLen = AES_128;
+            else if (len == "192") args.keyLen = AES_192;
+            else if (len == "256") args.keyLen = AES_256;
+            else throw invalid_argument("ЧԿ: " + len);
+        }
+        else if (arg == "-b" || arg == "--backend") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٺ˲ֵ");
+            string backend = argv[++i];
+            if (backend == "auto") args.backend = BACKEND_AUTO;
+            else if (backend == "portable") args.backend = BACKEND_PORTABLE;
+            else if (backend == "ttable") args.backend = BACKEND_TTABLE;
+            else if (backend == "bitslice") args.backend = BACKEND_BITSLICE;
+            else if (backend == "aesni") args.backend = BACKEND_AESNI;
+            else throw invalid_argument("Чĺ: " + backend);
+        }
+        else if (arg == "-s" || arg == "--segment") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٷֶγȲֵ");
+            string segment = argv[++i];
+            if (segment == "8") args.segment = 8;
+            else if (segment == "128") args.segment = 128;
+            else throw invalid_argument("Чķֶγ: " + segment);
+        }
+        else if (arg == "--stream") {
+            args.stream = true;
+        }
+        else if (arg == "--mmap") {
+            args.mmap = true;
+        }
+        else if (arg == "--inplace") {
+            args.mmap = true;
+            args.inplace = true;
+        }
+        else if (arg == "-t" || arg == "--threads") {
+            if (i + 1 >= argc) throw invalid_argument("ȱֵ߳");
+            args.threads = stoi(argv[++i]);
+            if (args.threads < 0) {
+                throw invalid_argument("߳Ϊ");
+            }
+            if (args.threads == 0) {
+                args.threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+            }
+        }
+        else if (arg == "-k" || arg == "--key") {
+            if (i + 1 >= argc) throw invalid_argument("ȱԿֵ");
+            args.key = argv[++i];
+        }
+        else if (arg == "-i" || arg == "--iv") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٳʼֵ");
+            args.iv = argv[++i];
+        }
+        else if (arg == "--aad") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٸ֤ݲֵ");
+            args.aad = argv[++i];
+        }
+        else if (arg == "-f" || arg == "--file") {
+            if (i + 1 >= argc) throw invalid_argument("ȱļֵ");
+            args.inputFile = argv[++i];
+            args.inputFiles.push_back(args.inputFile);
+        }
+        else if (arg == "-o" || arg == "--output") {
+            if (i + 1 >= argc) throw invalid_argument("ȱļֵ");
+            args.outputFile = argv[++i];
+            args.outputFiles.push_back(args.outputFile);
+        }
+        else if (arg == "--sector-size") {
+            if (i + 1 >= argc) throw invalid_argument("ȱСֵ");
+            args.sectorSize = static_cast<size_t>(parseSize(argv[++i]));
+        }
+        else if (arg == "--offset") {
+            if (i + 1 >= argc) throw invalid_argument("ȱʼλòֵ");
+            args.offset = parseSize(argv[++i]);
+            args.hasRange = true;
+        }
+        else if (arg == "--length") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٳȲֵ");
+            args.length = parseSize(argv[++i]);
+            args.hasRange = true;
+            args.hasLength = true;
+        }
+        else if (arg == "--range") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٷΧֵ");
+            string range = argv[++i];
+            size_t colon = range.find(':');
+            if (colon == string::npos) {
+                throw invalid_argument("ΧʽӦΪ :");
+            }
+            args.rangeStart = parseSize(range.substr(0, colon));
+            if (colon + 1 < range.size()) {
+                args.rangeLength = parseSize(range.substr(colon + 1));
+            }
+            args.byteRange = true;
+        }
+        else if (arg == "--checkpoint") {
+            if (i + 1 >= argc) throw invalid_argument("ȱټļֵ");
+            args.checkpointFile = argv[++i];
+        }
+        else if (arg == "--checkpoint-interval") {
+            if (i + 1 >= argc) throw invalid_argument("ȱټֵ");
+            args.checkpointInterval = parseSize(argv[++i]);
+        }
+        else if (arg == "--batch") {
+            if (i + 1 >= argc) throw invalid_argument("ȱ嵥ֵ");
+            args.batchFile = argv[++i];
+        }
+        else if (arg == "-h" || arg == "--help") {
+            cout << "AESӽܹ" << endl;
+            cout << "÷: " << argv[0] << " [ѡ]" << endl;
+            cout << "      " << argv[0] << " bench [ѡ]   ׼ԣbench -h鿴ѡ" << endl;
+            cout << "ѡ:" << endl;
+            cout << "  -m, --mode       ģʽ: encrypt()  decrypt()Ĭencrypt" << endl;
+            cout << "  -a, --aes-mode   AESģʽ: ecb, cbc, cfb, ofb, ctr, gcm(֤), xts(̾)Ĭecb" << endl;
+            cout << "  -l, --key-length Կ: 128, 192, 256Ĭ128" << endl;
+            cout << "  -b, --backend    ܺ: auto, portable(οʵ), ttable(T), bitslice(λƬʱ), aesniĬauto" << endl;
+            cout << "  -s, --segment    CFB/OFBֶγ: 8(ֽڣݾļ), 128()Ĭ8" << endl;
+            cout << "  -t, --threads    ECBCBCܡCFB-128ܺCTRʹõ߳ʱΪͬʱļ0ʾCPUĬ1" << endl;
+            cout << "      --stream     ʽֶζдڴռù̶ʺϳļ" << endl;
+            cout << "      --mmap       ڴӳļֱӳҳϼӽ" << endl;
+            cout << "      --inplace    ļԭؼӽ(CFB/OFB/CTR/XTS)ļ" << endl;
+            cout << "  -k, --key        Կ";
+            cout << " 16(AES-128), 24(AES-192)  32(AES-256) ַXTSΪԿ3264ַ" << endl;
+            cout << "  -i, --iv         ʼ16ַ(CBC/CFB/OFB/CTRģʽҪ)GCMΪ12(Ƽ)16ַ" << endl;
+            cout << "      --aad        GCM֤ݣ֤ܣʱͬ" << endl;
+            cout << "      --sector-size XTSС16ıĬ512" << endl;
+            cout << "      --offset     XTSھеʼλã룩šʱļ˴ȡ" << endl;
+            cout << "                   ʱдļ˴Ҳضļ޲еĲ" << endl;
+            cout << "      --length     XTSֽĬϵļĩβֵɴK/M/G׺" << endl;
+            cout << "  -f, --file       ļ·" << endl;
+            cout << "  -o, --output     ļ·θ-f/-oʱ˳ԣļ" << endl;
+            cout << "      --range      :ȣCTR/OFBֻļеһΣʡʱļĩβֱӶλ" << endl;
+            cout << "                   ʱ뷶ΧȳȣOFBҪ--checkpointֵɴK/M/G׺" << endl;
+            cout << "      --checkpoint OFBļļʱɣ--rangeʱжȡļĴ״̬" << endl;
+            cout << "      --checkpoint-interval 16ıĬ1M" << endl;
+            cout << "      --batch      嵥ÿΪ ļ<Tab>ļ[<Tab>ʼ]#ͷΪע" << endl;
+            cout << "  -h, --help       ʾϢ" << endl;
+            exit(0);
+        }
+        else {
+            throw invalid_argument("ЧĲ: " + arg);
+        }
+    }
+
+    // -f/-o嵥ļһԿչ
+    args.batch = !args.batchFile.empty() || args.inputFiles.size() > 1;
+    if (args.batch) {
+        if (args.inputFiles.size() != args.outputFiles.size()) {
+            throw invalid_argument("ʱ-f-oɶԸ");
+        }
+        if (args.stream || args.mmap) {
+            throw invalid_argument("--stream--mmap--inplaceͬʱʹ");
+        }
+        if (args.aesMode == XTS) {
+            throw invalid_argument("֧XTSģʽ");
+        }
+    }
+
+    // ֤Ҫ
+    if (args.inputFile.empty() && !args.batch) {
+        throw invalid_argument("ṩļ");
+    }
+    if (args.outputFile.empty() && !args.inplace && !args.batch) {
+        throw invalid_argument("ṩļ");
+    }
+    if (args.inplace && (args.aesMode == ECB || args.aesMode == CBC || args.aesMode == GCM)) {
+        throw invalid_argument("ԭشֻ֧CFBOFBCTRXTSģʽ");
+    }
+    if (args.stream && args.mmap) {
+        throw invalid_argument("--stream--mmap--inplaceͬʱʹ");
+    }
+    if (args.key.empty()) {
+        throw invalid_argument("ṩԿ");
+    }
+
+    // ֤Կ
+    int keySize = (args.keyLen == AES_128) ? 16 : (args.keyLen == AES_192) ? 24 : 32;
+    if (args.aesMode == XTS) {
+        // XTSʹͬȵԿԿtweakԿ
+        if (args.keyLen == AES_192) {
+            throw invalid_argument("XTSֻ֧128λ256λԿ");
+        }
+        keySize *= 2;
+    }
+    if (args.key.length() != keySize) {
+        throw invalid_argument("Կ" + to_string(keySize) + "ַ");
+    }
+
+    // ֽ֤ڷΧͼ
+    if (args.byteRange) {
+        if (args.aesMode != CTR && args.aesMode != OFB) {
+            throw invalid_argument("--rangeֻ֧CTROFBģʽ");
+        }
+        if (args.aesMode == OFB && args.checkpointFile.empty()) {
+            throw invalid_argument("OFBģʽ--rangeҪ--checkpointļ");
+        }
+        if (args.stream || args.mmap || args.batch) {
+            throw invalid_argument("--rangeֱӶλȡ--stream--mmap--inplaceͬʱʹ");
+        }
+    }
+    if (!args.checkpointFile.empty()) {
+        if (args.aesMode != OFB) {
+            throw invalid_argument("--checkpointֻOFBģʽ");
+        }
+        if (args.batch) {
+            throw invalid_argument("֧--checkpoint");
+        }
+        if (args.checkpointInterval == 0 || args.checkpointInterval % 16 != 0) {
+            throw invalid_argument("16ı");
+        }
+    }
+
+    // ֤XTS
+    if (args.aesMode == XTS) {
+        if (args.stream || (args.mmap && !args.inplace)) {
+            throw invalid_argument("XTSģʽдļ--stream--mmapͬʱʹ");
+        }
+        if (args.sectorSize < 16 || args.sectorSize % 16 != 0) {
+            throw invalid_argument("С16ı");
+        }
+        if (args.offset % args.sectorSize != 0) {
+            throw invalid_argument("--offsetС");
+        }
+    }
+    else if (args.hasRange) {
+        throw invalid_argument("--offset--lengthֻXTSģʽ");
+    }
+
+    // ֤IV嵥пΪÿļָ
+    if (args.batchFile.empty() || !args.iv.empty()) {
+        validateIV(args.aesMode, args.iv);
+    }
+
+    return args;
+}
+
+// ȡļ
+vector<uint8_t> readFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file) {
+        throw runtime_error("޷ļ: " + filename);
+    }
+
+    // ȡļС
+    file.seekg(0, ios::end);
+    size_t size = file.tellg();
+    file.seekg(0, ios::beg);
+
+    // ȡļ
+    vector<uint8_t> data(size);
+    file.read(reinterpret_cast<char*>(data.data()), size);
+
+    return data;
+}
+
+// дļ
+void writeFile(const string& filename, const vector<uint8_t>& data) {
+    ofstream file(filename, ios::binary);
+    if (!file) {
+        throw runtime_error("޷ļ: " + filename);
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+// ڴӳļӽֱӶдӳҳ棬м仺
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), size(0) {
+#if defined(_WIN32)
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        fd = -1;
+#endif
+    }
+
+    ~MappedFile() {
+        try {
+            close(size);
+        }
+        catch (...) {
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // ӳļwritableΪtrueʱ޸ֱдļ
+    void open(const string& filename, bool writable) {
+#if defined(_WIN32)
+        file = CreateFileA(filename.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+            FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw runtime_error("޷ļ: " + filename);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            throw runtime_error("޷ȡļС: " + filename);
+        }
+        size = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+        fd = ::open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("޷ļ: " + filename);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            throw runtime_error("޷ȡļС: " + filename);
+        }
+        size = static_cast<uint64_t>(st.st_size);
+#endif
+        map(writable);
+    }
+
+    // ضϣļԤչfileSizeֽںӳ䣬closeʱضϵʵʳ
+    void create(const string& filename, uint64_t fileSize) {
+#if defined(_WIN32)
+        file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+            CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw runtime_error("޷ļ: " + filename);
+        }
+#else
+        fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw runtime_error("޷ļ: " + filename);
+        }
+        if (ftruncate(fd, static_cast<off_t>(fileSize)) != 0) {
+            throw runtime_error("޷ļС: " + filename);
+        }
+#endif
+        size = fileSize;
+        map(true);
+    }
+
+    // ӳ䲢رļfinalSizeСӳ䳤ʱضļ
+    void close(uint64_t finalSize) {
+#if defined(_WIN32)
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        bool ok = true;
+        if (file != INVALID_HANDLE_VALUE) {
+            if (finalSize < size) {
+                LARGE_INTEGER pos;
+                pos.QuadPart = static_cast<LONGLONG>(finalSize);
+                ok = SetFilePointerEx(file, pos, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+            }
+            CloseHandle(file);
+        }
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (data != nullptr) {
+            munmap(data, static_cast<size_t>(size));
+        }
+        bool ok = true;
+        if (fd >= 0) {
+            if (finalSize < size) {
+                ok = ftruncate(fd, static_cast<off_t>(finalSize)) == 0;
+            }
+            ::close(fd);
+        }
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+        if (!ok) {
+            throw runtime_error("޷ضļ");
+        }
+    }
+
+    uint8_t* data;
+    uint64_t size;
+
+private:
+    void map(bool writable) {
+        // ļ޷ӳ䣬Ϊ0
+        if (size == 0) {
+            return;
+        }
+        if (size > static_cast<uint64_t>(SIZE_MAX)) {
+            throw runtime_error("ļ޷ӳ");
+        }
+#if defined(_WIN32)
+        mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+            static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+        if (mapping == nullptr) {
+            throw runtime_error("ڴӳʧ");
+        }
+        data = static_cast<uint8_t*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        if (data == nullptr) {
+            throw runtime_error("ڴӳʧ");
+        }
+#else
+        void* p = mmap(nullptr, static_cast<size_t>(size), writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+            MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            throw runtime_error("ڴӳʧ");
+        }
+        data = static_cast<uint8_t*>(p);
+
+        // ˳ʣں˼ӴԤѴҳҳɼTLBȱʧΪʾ֧ʱԣ
+        madvise(p, static_cast<size_t>(size), MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        madvise(p, static_cast<size_t>(size), MADV_HUGEPAGE);
+#endif
+#endif
+    }
+
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+};
+
+// ʽʱÿζ
+const size_t STREAM_CHUNK_SIZE = 4 * 1024 * 1024;
+
+// ʽļֶζ롢д̨߳ԤһβдһεĽ
+// ʹI/Oӽصڴռù̶Ϊ4ֶλ{ֽ, дֽ}
+pair<uint64_t, uint64_t> streamFile(const string& inputFile, const string& outputFile, Stream& stream) {
+    ifstream in(inputFile, ios::binary);
+    if (!in) {
+        throw runtime_error("޷ļ: " + inputFile);
+    }
+    ofstream out(outputFile, ios::binary);
+    if (!out) {
+        throw runtime_error("޷ļ: " + outputFile);
+    }
+
+    vector<uint8_t> inBuf[2];
+    vector<uint8_t> outBuf[2];
+    inBuf[0].resize(STREAM_CHUNK_SIZE);
+    inBuf[1].resize(STREAM_CHUNK_SIZE);
+    outBuf[0].reserve(STREAM_CHUNK_SIZE + 16);
+    outBuf[1].reserve(STREAM_CHUNK_SIZE + 16);
+
+    auto readChunk = [&in](vector<uint8_t>* buf) -> size_t {
+        in.read(reinterpret_cast<char*>(buf->data()), buf->size());
+        return static_cast<size_t>(in.gcount());
+    };
+    auto writeChunk = [&out](const vector<uint8_t>* buf) {
+        out.write(reinterpret_cast<const char*>(buf->data()), buf->size());
+        if (!out) {
+            throw runtime_error("дļʧ");
+        }
+    };
+
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    int cur = 0;
+    future<size_t> reading = async(launch::async, readChunk, &inBuf[0]);
+    future<void> writing;
+
+    while (true) {
+        size_t n = reading.get();
+        if (n == 0) {
+            break;
+        }
+        bytesRead += n;
+
+        // Ԥһ
+        reading = async(launch::async, readChunk, &inBuf[cur ^ 1]);
+
+        outBuf[cur].clear();
+        stream.update(inBuf[cur].data(), n, outBuf[cur]);
+
+        // һдٿʼдΣ֤˳
+        if (writing.valid()) {
+            writing.get();
+        }
+        bytesWritten += outBuf[cur].size();
+        writing = async(launch::async, writeChunk, &outBuf[cur]);
+        cur ^= 1;
+    }
+
+    if (writing.valid()) {
+        writing.get();
+    }
+
+    vector<uint8_t> tail;
+    stream.finish(tail);
+    writeChunk(&tail);
+    bytesWritten += tail.size();
+
+    return { bytesRead, bytesWritten };
+}
+
+// ڴӳ䴦ļʽֱӶдӳҳ棬ļһ룬ûждĿ
+// ԭشʱдļ{ֽ, дֽ}
+pair<uint64_t, uint64_t> mapFile(const Args& args, Stream& stream) {
+    MappedFile input;
+    input.open(args.inputFile, args.inplace);
+    size_t len = static_cast<size_t>(input.size);
+
+    if (args.inplace) {
+        // CFB/OFB/CTRȳ״updateʱûδݣֱӸ
+        size_t written = stream.update(input.data, len, input.data);
+        stream.finish(input.data + written);
+        input.close(len);
+        return { len, len };
+    }
+
+    // һ飬Ȱ޴ɺضϵʵʳ
+    MappedFile output;
+    output.create(args.outputFile, static_cast<uint64_t>(len) + 16);
+    size_t written = stream.update(input.data, len, output.data);
+    written += stream.finish(output.data + written);
+    output.close(written);
+    input.close(len);
+    return { len, written };
+}
+
+// XTSļֻд[offset, offset + length)ǵֶζ롢̴߳дڴռù̶
+// ھеλþţʱļoffsetȡʱдļoffset
+// ָΧʱضļ޲еĲԭشʱдļͬһΧ
+// {ֽ, дֽ}
+pair<uint64_t, uint64_t> xtsFile(const Args& args, const Context& dataKey, const Context& tweakKey) {
+    uint64_t inPos = (args.opMode == DECRYPT || args.inplace) ? args.offset : 0;
+    uint64_t outPos = (args.opMode == ENCRYPT || args.inplace) ? args.offset : 0;
+
+    fstream in(args.inputFile, ios::binary | ios::in | (args.inplace ? ios::out : ios::in));
+    if (!in) {
+        throw runtime_error("޷ļ: " + args.inputFile);
+    }
+    in.seekg(0, ios::end);
+    uint64_t inputSize = static_cast<uint64_t>(in.tellg());
+    if (inPos > inputSize) {
+        throw invalid_argument("--offsetļС");
+    }
+    uint64_t length = args.hasLength ? args.length : inputSize - inPos;
+    if (length > inputSize - inPos) {
+        throw invalid_argument("ΧļС");
+    }
+    uint64_t tailLen = length % args.sectorSize;
+    if (tailLen != 0 && tailLen < 16) {
+        throw invalid_argument("Χһ16ֽ");
+    }
 
-    uint8_t counter[16];
-    uint8_t encryptedCounter[16];
-    memcpy(counter, iv, 16);
+    // ԭشʱдļ޲ʱļݣļʱ½
+    fstream outFile;
+    fstream& out = args.inplace ? in : outFile;
+    if (!args.inplace) {
+        bool patch = args.opMode == ENCRYPT && args.hasRange;
+        if (patch) {
+            outFile.open(args.outputFile, ios::binary | ios::in | ios::out);
+        }
+        if (!outFile.is_open()) {
+            outFile.open(args.outputFile, ios::binary | ios::out | ios::trunc);
+        }
+        if (!outFile) {
+            throw runtime_error("޷ļ: " + args.outputFile);
+        }
+    }
 
-    // ֽڴ
-    for (size_t i = 0; i < data.size(); i++) {
-        // ÿ鿪ʼʱܼ
-        if (i % 16 == 0) {
-            memcpy(encryptedCounter, counter, 16);
-            aesEncryptBlock(encryptedCounter, w, keyLen);
-
-            // 1ģʽ
-            for (int j = 15; j >= 0; j--) {
-                if (++counter[j] != 0) {
-                    break;
+    // ÿΪֻһοԲβ
+    size_t chunkSize = max<size_t>(1, STREAM_CHUNK_SIZE / args.sectorSize) * args.sectorSize;
+    vector<uint8_t> buffer(static_cast<size_t>(min<uint64_t>(chunkSize, length)));
+    for (uint64_t done = 0; done < length; ) {
+        size_t n = static_cast<size_t>(min<uint64_t>(chunkSize, length - done));
+        in.seekg(inPos + done);
+        in.read(reinterpret_cast<char*>(buffer.data()), n);
+        if (static_cast<size_t>(in.gcount()) != n) {
+            throw runtime_error("ȡļʧ");
+        }
+
+        xtsCrypt(dataKey, tweakKey, (args.offset + done) / args.sectorSize, args.sectorSize,
+            buffer.data(), buffer.data(), n, args.opMode, args.threads);
+
+        out.seekp(outPos + done);
+        out.write(reinterpret_cast<const char*>(buffer.data()), n);
+        if (!out) {
+            throw runtime_error("дļʧ");
+        }
+        done += n;
+    }
+    return { length, length };
+}
+
+// OFBļ
+//   ƫ 0   8ֽ   "AESOFBCP"
+//   ƫ 8   1ֽ   汾ƫ12 1ֽ ֶγȣ8128ౣΪ0
+//   ƫ 16  8ֽ   Сˣ
+//   ƫ 24  8ֽ   Сˣ
+//   ƫ 32  16ֽ  УֵܺIVȷԿIVʱһ
+//   ƫ 48  ÿ16ֽڣjΪ(j + 1) * ֽںļĴֵ
+// ĴֵԿı棬ȫԿAES-128Կ
+const char OFB_CHECKPOINT_MAGIC[8] = { 'A', 'E', 'S', 'O', 'F', 'B', 'C', 'P' };
+const uint8_t OFB_CHECKPOINT_VERSION = 1;
+const size_t OFB_CHECKPOINT_HEADER = 48;
+
+// ԿԿһ̶õ
+Context checkpointKey(const Context& key) {
+    uint8_t derived[16] = { 'O', 'F', 'B', ' ', 'c', 'h', 'e', 'c', 'k', 'p', 'o', 'i', 'n', 't', 0, 0 };
+    encryptBlock(derived, derived, key);
+    return Context(derived, AES_128, key.backend);
+}
+
+// OFBĴǰbytesֽڣݣOFB-128ÿ顢OFB-8ÿֽڼһμĴ
+void advanceOfb(const Context& key, int segment, uint8_t* registerValue, uint64_t bytes) {
+    uint64_t steps = segment == 128 ? bytes / 16 : bytes;
+    for (uint64_t i = 0; i < steps; i++) {
+        encryptBlock(registerValue, registerValue, key);
+    }
+}
+
+// OFBļΪOFBصļӽܼ¼ĴֵҪƽһĴ
+// ļͷеļcloseʱд
+class OfbCheckpointWriter {
+public:
+    OfbCheckpointWriter(const Args& args, const Context& key, const uint8_t* iv)
+        : out(args.checkpointFile, ios::binary), ckKey(checkpointKey(key)), interval(args.checkpointInterval), count(0) {
+        if (!out) {
+            throw runtime_error("޷ļ: " + args.checkpointFile);
+        }
+
+        uint8_t header[OFB_CHECKPOINT_HEADER] = {};
+        memcpy(header, OFB_CHECKPOINT_MAGIC, sizeof(OFB_CHECKPOINT_MAGIC));
+        header[8] = OFB_CHECKPOINT_VERSION;
+        header[12] = static_cast<uint8_t>(args.segment);
+        storeLE64(header + 16, interval);
+        encryptBlock(iv, header + 32, ckKey);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    // ӽ̵ܹĻص
+    OfbCheckpoint hook() {
+        OfbCheckpoint checkpoint;
+        checkpoint.interval = interval;
+        checkpoint.callback = [this](uint64_t, const uint8_t* registerValue) {
+            uint8_t entry[16];
+            encryptBlock(registerValue, entry, ckKey);
+            out.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+            count++;
+        };
+        return checkpoint;
+    }
+
+    // дرļؼ
+    uint64_t close() {
+        uint8_t countField[8];
+        storeLE64(countField, count);
+        out.seekp(24);
+        out.write(reinterpret_cast<const char*>(countField), sizeof(countField));
+        out.close();
+        if (!out) {
+            throw runtime_error("дļʧ");
+        }
+        return count;
+    }
+
+private:
+    ofstream out;
+    Context ckKey;
+    uint64_t interval;
+    uint64_t count;
+};
+
+// Ӽļȡoffset㣬ĴֵдregisterValueظüλ
+uint64_t loadOfbCheckpoint(const Args& args, const Context& key, const uint8_t* iv, uint64_t offset, uint8_t* registerValue) {
+    ifstream in(args.checkpointFile, ios::binary);
+    if (!in) {
+        throw runtime_error("޷򿪼ļ: " + args.checkpointFile);
+    }
+
+    uint8_t header[OFB_CHECKPOINT_HEADER];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (static_cast<size_t>(in.gcount()) != sizeof(header) || memcmp(header, OFB_CHECKPOINT_MAGIC, sizeof(OFB_CHECKPOINT_MAGIC)) != 0) {
+        throw runtime_error("Чļļ");
+    }
+    if (header[8] != OFB_CHECKPOINT_VERSION) {
+        throw runtime_error("ֵ֧ļļ汾");
+    }
+    if (header[12] != args.segment) {
+        throw runtime_error("ļķֶγ-sһ");
+    }
+    uint64_t interval = loadLE64(header + 16);
+    uint64_t count = loadLE64(header + 24);
+    if (interval == 0 || interval % 16 != 0) {
+        throw runtime_error("Чļļ");
+    }
+
+    Context ckKey = checkpointKey(key);
+    uint8_t check[16];
+    encryptBlock(iv, check, ckKey);
+    if (!constantTimeEqual(check, header + 32, 16)) {
+        throw runtime_error("ļԿʼƥ");
+    }
+
+    memcpy(registerValue, iv, 16);
+    uint64_t j = min(offset / interval, count);
+    if (j == 0) {
+        return 0;
+    }
+    uint8_t entry[16];
+    in.seekg(OFB_CHECKPOINT_HEADER + (j - 1) * 16);
+    in.read(reinterpret_cast<char*>(entry), sizeof(entry));
+    if (static_cast<size_t>(in.gcount()) != sizeof(entry)) {
+        throw runtime_error("ļ");
+    }
+    decryptBlock(entry, registerValue, ckKey);
+    return j * interval;
+}
+
+// ֽڷΧCTR/OFBļֱӶλΧڵĿ飬ֻ벢һΣ÷ΧĽ
+// CTRʼΪIVϿţOFBļĴļƽ㡣{ֽ, дֽ}
+pair<uint64_t, uint64_t> rangeFile(const Args& args, const Context& key, const uint8_t* iv) {
+    ifstream in(args.inputFile, ios::binary);
+    if (!in) {
+        throw runtime_error("޷ļ: " + args.inputFile);
+    }
+    in.seekg(0, ios::end);
+    uint64_t size = static_cast<uint64_t>(in.tellg());
+    if (args.rangeStart > size) {
+        throw invalid_argument("--range㳬ļС");
+    }
+    uint64_t start = args.rangeStart;
+    uint64_t length = args.rangeLength == UINT64_MAX ? size - start : args.rangeLength;
+    if (length > size - start) {
+        throw invalid_argument("--rangeļС");
+    }
+
+    ofstream out(args.outputFile, ios::binary);
+    if (!out) {
+        throw runtime_error("޷ļ: " + args.outputFile);
+    }
+
+    // ڿĿͷǰ治ڷΧڵֽ
+    uint64_t aligned = start / 16 * 16;
+    uint8_t registerValue[16];
+    if (args.aesMode == CTR) {
+        memcpy(registerValue, iv, 16);
+        addCounter(registerValue, aligned / 16);
+    }
+    else {
+        uint64_t from = loadOfbCheckpoint(args, key, iv, aligned, registerValue);
+        advanceOfb(key, args.segment, registerValue, aligned - from);
+    }
+
+    uint64_t end = start + length;
+    vector<uint8_t> buffer(static_cast<size_t>(min<uint64_t>(STREAM_CHUNK_SIZE, end - aligned)));
+    for (uint64_t pos = aligned; pos < end; ) {
+        size_t n = static_cast<size_t>(min<uint64_t>(STREAM_CHUNK_SIZE, end - pos));
+        in.seekg(pos);
+        in.read(reinterpret_cast<char*>(buffer.data()), n);
+        if (static_cast<size_t>(in.gcount()) != n) {
+            throw runtime_error("ȡļʧ");
+        }
+
+        if (args.aesMode == CTR) {
+            ctrCryptParallel(buffer.data(), buffer.data(), n, key, registerValue, args.threads);
+        }
+        else if (args.segment == 8) {
+            ofb8Crypt(buffer.data(), buffer.data(), n, key, registerValue);
+        }
+        else {
+            ofb128Crypt(buffer.data(), buffer.data(), n, key, registerValue);
+        }
+
+        size_t skip = static_cast<size_t>(pos < start ? start - pos : 0);
+        out.write(reinterpret_cast<const char*>(buffer.data() + skip), n - skip);
+        if (!out) {
+            throw runtime_error("дļʧ");
+        }
+        pos += n;
+    }
+    return { length, length };
+}
+
+// Ϣ
+void printSummary(const Args& args, const Context& key, long long milliseconds) {
+    cout << ": " << (args.opMode == ENCRYPT ? "" : "") << " " << endl;
+    cout << "AESģʽ: ";
+    switch (args.aesMode) {
+    case ECB: cout << "ECB"; break;
+    case CBC: cout << "CBC"; break;
+    case CFB: cout << "CFB-" << args.segment; break;
+    case OFB: cout << "OFB-" << args.segment; break;
+    case CTR: cout << "CTR"; break;
+    case GCM: cout << "GCM"; break;
+    case XTS: cout << "XTS (" << args.sectorSize << "ֽ)"; break;
+    }
+    cout << endl;
+    cout << "Կ: " << (args.keyLen == AES_128 ? 128 : (args.keyLen == AES_192 ? 192 : 256)) << "λ" << endl;
+    cout << ": " << backendName(key.backend) << endl;
+    cout << "߳: " << args.threads << endl;
+    if (args.stream) {
+        cout << "ʽ: ʽ" << endl;
+    }
+    else if (args.inplace) {
+        cout << "ʽ: ڴӳ(ԭ)" << endl;
+    }
+    else if (args.mmap) {
+        cout << "ʽ: ڴӳ" << endl;
+    }
+    cout << "ʱ: " << milliseconds << " " << endl;
+}
+
+// ļڴѡģʽ
+// OFBʱcheckpointΪص
+vector<uint8_t> processData(const vector<uint8_t>& data, const Args& args, const Context& key, const uint8_t* iv,
+    const OfbCheckpoint& checkpoint = OfbCheckpoint()) {
+    switch (args.aesMode) {
+    case ECB:
+        if (args.opMode == ENCRYPT) {
+            return ecbEncrypt(data, key, args.threads);
+        }
+        else {
+            return ecbDecrypt(data, key, args.threads);
+        }
+    case CBC:
+        if (args.opMode == ENCRYPT) {
+            return cbcEncrypt(data, key, iv);
+        }
+        else {
+            return cbcDecrypt(data, key, iv, args.threads);
+        }
+    case CFB:
+        if (args.segment == 8) {
+            return cfbProcess(data, key, iv, args.opMode);
+        }
+        else if (args.opMode == ENCRYPT) {
+            return cfb128Encrypt(data, key, iv);
+        }
+        else {
+            return cfb128Decrypt(data, key, iv, args.threads);
+        }
+    case OFB:
+        if (args.segment == 8) {
+            return ofbProcess(data, key, iv, checkpoint);
+        }
+        else {
+            return ofb128Process(data, key, iv, checkpoint);
+        }
+    case CTR:
+        return ctrProcess(data, key, iv, args.threads);
+    case GCM:
+        return gcmProcess(data, key, args.iv, args.aad, args.opMode);
+    case XTS:
+        // XTSҪԿxtsFile
+        break;
+    }
+
+    throw invalid_argument("ЧAESģʽ");
+}
+
+// еһļ
+struct BatchJob {
+    string inputFile;
+    string outputFile;
+    string iv;              // ļʹõĳʼ
+    uint64_t inputSize;
+    uint64_t outputSize;
+    double milliseconds;    // ӿʼȡдɵĺʱ
+    string error;           // ʧʱԭ
+};
+
+// ȡ嵥ÿΪ ļ<Tab>ļ[<Tab>ʼ]Tabʱհ׷ָ
+// к#ͷкԣδָʼļʹ-iֵ
+vector<BatchJob> loadManifest(const string& filename, const string& defaultIV) {
+    ifstream file(filename);
+    if (!file) {
+        throw runtime_error("޷嵥: " + filename);
+    }
+
+    vector<BatchJob> jobs;
+    string line;
+    int lineNo = 0;
+    while (getline(file, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        vector<string> fields;
+        if (line.find('\t') != string::npos) {
+            stringstream ss(line);
+            string field;
+            while (getline(ss, field, '\t')) {
+                fields.push_back(field);
+            }
+        }
+        else {
+            stringstream ss(line);
+            string field;
+            while (ss >> field) {
+                fields.push_back(field);
+            }
+        }
+        if (fields.size() < 2 || fields.size() > 3) {
+            throw invalid_argument("嵥" + to_string(lineNo) + "иʽ");
+        }
+
+        BatchJob job = BatchJob();
+        job.inputFile = fields[0];
+        job.outputFile = fields[1];
+        job.iv = fields.size() == 3 ? fields[2] : defaultIV;
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+// ̣߳ȡļ롢ӽܺ󽻸̨д
+// дͬʱȡһļ
+void batchWorker(vector<BatchJob>& jobs, atomic<size_t>& next, const Args& args, const Context& key) {
+    future<void> writing;
+    while (true) {
+        size_t i = next++;
+        if (i >= jobs.size()) {
+            break;
+        }
+        BatchJob& job = jobs[i];
+        auto start = high_resolution_clock::now();
+
+        // ̳߳ذļУļٲ
+        Args fileArgs = args;
+        fileArgs.threads = 1;
+        fileArgs.iv = job.iv;
+        uint8_t iv[16];
+        memcpy(iv, job.iv.data(), min(job.iv.size(), sizeof(iv)));
+
+        vector<uint8_t> output;
+        try {
+            vector<uint8_t> input = readFile(job.inputFile);
+            job.inputSize = input.size();
+            output = processData(input, fileArgs, key, iv);
+        }
+        catch (const exception& e) {
+            job.error = e.what();
+            continue;
+        }
+
+        // һļддļÿ߳ͬʱֻһݴд
+        if (writing.valid()) {
+            writing.get();
+        }
+        writing = async(launch::async, [&job, start](vector<uint8_t> data) {
+            try {
+                writeFile(job.outputFile, data);
+                job.outputSize = data.size();
+            }
+            catch (const exception& e) {
+                job.error = e.what();
+            }
+            job.milliseconds = duration<double, milli>(high_resolution_clock::now() - start).count();
+        }, move(output));
+    }
+
+    if (writing.valid()) {
+        writing.get();
+    }
+}
+
+// ļļһԿչ̳߳ذļдʧܵļ
+size_t processBatch(const Args& args, const Context& key) {
+    vector<BatchJob> jobs;
+    if (!args.batchFile.empty()) {
+        jobs = loadManifest(args.batchFile, args.iv);
+    }
+    for (size_t i = 0; i < args.inputFiles.size(); i++) {
+        BatchJob job = BatchJob();
+        job.inputFile = args.inputFiles[i];
+        job.outputFile = args.outputFiles[i];
+        job.iv = args.iv;
+        jobs.push_back(job);
+    }
+    if (jobs.empty()) {
+        throw invalid_argument("嵥ûļ");
+    }
+
+    for (const BatchJob& job : jobs) {
+        validateIV(args.aesMode, job.iv);
+    }
+    // ԿģʽͬһԿͳʼļй¶ĵ
+    if (args.opMode == ENCRYPT && args.aesMode != ECB && args.aesMode != CBC) {
+        vector<string> ivs;
+        for (const BatchJob& job : jobs) {
+            ivs.push_back(job.iv);
+        }
+        sort(ivs.begin(), ivs.end());
+        if (adjacent_find(ivs.begin(), ivs.end()) != ivs.end()) {
+            throw invalid_argument("CFB/OFB/CTR/GCMʱÿļʹòͬĳʼ嵥ָ");
+        }
+    }
+
+    int workers = static_cast<int>(min<size_t>(args.threads, jobs.size()));
+    atomic<size_t> next(0);
+    auto start = high_resolution_clock::now();
+    vector<thread> pool;
+    for (int t = 0; t < workers; t++) {
+        pool.emplace_back(batchWorker, ref(jobs), ref(next), cref(args), cref(key));
+    }
+    for (thread& t : pool) {
+        t.join();
+    }
+    double totalMs = duration<double, milli>(high_resolution_clock::now() - start).count();
+
+    // ļĽ
+    uint64_t totalIn = 0;
+    uint64_t totalOut = 0;
+    size_t failed = 0;
+    vector<double> latencies;
+    cout << fixed << setprecision(2);
+    for (const BatchJob& job : jobs) {
+        if (!job.error.empty()) {
+            cout << "ʧ: " << job.inputFile << " -> " << job.outputFile << ": " << job.error << endl;
+            failed++;
+            continue;
+        }
+        cout << job.inputFile << " -> " << job.outputFile << " (" << job.inputSize << " -> " << job.outputSize
+            << " ֽ, " << job.milliseconds << " )" << endl;
+        totalIn += job.inputSize;
+        totalOut += job.outputSize;
+        latencies.push_back(job.milliseconds);
+    }
+
+    // ܣ͵ļʱķֲ
+    cout << ": " << (args.opMode == ENCRYPT ? "" : "") << " " << endl;
+    cout << ": " << backendName(key.backend) << endl;
+    cout << "߳: " << workers << endl;
+    cout << "ļ: " << jobs.size() - failed << " ɹ, " << failed << " ʧ" << endl;
+    cout << ": " << totalIn << " ֽڶ, " << totalOut << " ֽд" << endl;
+    cout << "ܺʱ: " << totalMs << " " << endl;
+    if (totalMs > 0) {
+        cout << ": " << totalIn / totalMs / 1000.0 << " MB/s, " << latencies.size() * 1000.0 / totalMs << " ļ/" << endl;
+    }
+    if (!latencies.empty()) {
+        sort(latencies.begin(), latencies.end());
+        double sum = 0;
+        for (double ms : latencies) {
+            sum += ms;
+        }
+        auto percentile = [&latencies](double p) {
+            return latencies[min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+        };
+        cout << "ļʱ(): С " << latencies.front() << ", ƽ " << sum / latencies.size()
+            << ", p50 " << percentile(0.50) << ", p99 " << percentile(0.99) << ",  " << latencies.back() << endl;
+    }
+    return failed;
+}
+
+// ===== ׼ =====
+
+// ȡʱTSCƵʼx86ƽ̨0
+uint64_t readCycleCounter() {
+#if AES_HAVE_AESNI
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Ųֲֵ
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// ׼Բ
+struct BenchArgs {
+    vector<AESMode> modes;
+    vector<KeyLength> keyLens;
+    vector<AESBackend> backends;
+    vector<OperationMode> ops;
+    vector<size_t> sizes;
+    int segment;         // CFB/OFBֶγ
+    int threads;
+    int warmup;          // ÿԤȵĵô
+    int minReps;         // ÿټʱĵô
+    double minTime;      // ÿټʱĺ
+    string jsonFile;     // JSONļ"-"ʾ׼
+};
+
+// һ飨ģʽԿȡˡĲԽ
+struct BenchResult {
+    AESMode mode;
+    KeyLength keyLen;
+    AESBackend backend;
+    OperationMode op;
+    size_t size;
+    size_t reps;
+    double mbPerSec;
+    double cyclesPerByte;
+    double p50Us;        // εúʱλ΢룩
+    double p99Us;
+};
+
+const char* modeName(AESMode mode) {
+    switch (mode) {
+    case ECB: return "ecb";
+    case CBC: return "cbc";
+    case CFB: return "cfb";
+    case OFB: return "ofb";
+    case CTR: return "ctr";
+    case GCM: return "gcm";
+    default: return "xts";
+    }
+}
+
+// benchĲargv[1]Ϊ"bench"
+BenchArgs parseBenchArgs(int argc, char* argv[]) {
+    BenchArgs args;
+    args.modes = { ECB, CBC, CFB, OFB, CTR, GCM, XTS };
+    args.keyLens = { AES_128, AES_192, AES_256 };
+    args.backends = { BACKEND_PORTABLE, BACKEND_TTABLE, BACKEND_BITSLICE };
+    if (cpuHasAESNI()) {
+        args.backends.push_back(BACKEND_AESNI);
+    }
+    args.ops = { ENCRYPT, DECRYPT };
+    args.sizes = { 64, 4 << 10, 64 << 10, 1 << 20 };
+    args.segment = 128;
+    args.threads = 1;
+    args.warmup = 2;
+    args.minReps = 5;
+    args.minTime = 100;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-a" || arg == "--aes-mode") {
+            if (!hasValue) throw invalid_argument("ȱAESģʽֵ");
+            args.modes.clear();
+            for (const string& mode : splitList(argv[++i])) {
+                if (mode == "ecb") args.modes.push_back(ECB);
+                else if (mode == "cbc") args.modes.push_back(CBC);
+                else if (mode == "cfb") args.modes.push_back(CFB);
+                else if (mode == "ofb") args.modes.push_back(OFB);
+                else if (mode == "ctr") args.modes.push_back(CTR);
+                else if (mode == "gcm") args.modes.push_back(GCM);
+                else if (mode == "xts") args.modes.push_back(XTS);
+                else throw invalid_argument("ЧAESģʽ: " + mode);
+            }
+        }
+        else if (arg == "-l" || arg == "--key-length") {
+            if (!hasValue) throw invalid_argument("ȱԿȲֵ");
+            args.keyLens.clear();
+            for (const string& len : splitList(argv[++i])) {
+                if (len == "128") args.keyLens.push_back(AES_128);
+                else if (len == "192") args.keyLens.push_back(AES_192);
+                else if (len == "256") args.keyLens.push_back(AES_256);
+                else throw invalid_argument("ЧԿ: " + len);
+            }
+        }
+        else if (arg == "-b" || arg == "--backend") {
+            if (!hasValue) throw invalid_argument("ȱٺ˲ֵ");
+            args.backends.clear();
+            for (const string& backend : splitList(argv[++i])) {
+                if (backend == "portable") args.backends.push_back(BACKEND_PORTABLE);
+                else if (backend == "ttable") args.backends.push_back(BACKEND_TTABLE);
+                else if (backend == "bitslice") args.backends.push_back(BACKEND_BITSLICE);
+                else if (backend == "aesni") args.backends.push_back(BACKEND_AESNI);
+                else throw invalid_argument("Чĺ: " + backend);
+            }
+        }
+        else if (arg == "-m" || arg == "--mode") {
+            if (!hasValue) throw invalid_argument("ȱģʽֵ");
+            args.ops.clear();
+            for (const string& op : splitList(argv[++i])) {
+                if (op == "encrypt") args.ops.push_back(ENCRYPT);
+                else if (op == "decrypt") args.ops.push_back(DECRYPT);
+                else throw invalid_argument("Чģʽ: " + op);
+            }
+        }
+        else if (arg == "--sizes") {
+            if (!hasValue) throw invalid_argument("ȱֵ");
+            args.sizes.clear();
+            for (const string& size : splitList(argv[++i])) {
+                args.sizes.push_back(static_cast<size_t>(parseSize(size)));
+                if (args.sizes.back() == 0) {
+                    throw invalid_argument("Ϊ0");
                 }
             }
         }
+        else if (arg == "-s" || arg == "--segment") {
+            if (!hasValue) throw invalid_argument("ȱٷֶγȲֵ");
+            args.segment = stoi(argv[++i]);
+            if (args.segment != 8 && args.segment != 128) {
+                throw invalid_argument("Чķֶγ: " + to_string(args.segment));
+            }
+        }
+        else if (arg == "-t" || arg == "--threads") {
+            if (!hasValue) throw invalid_argument("ȱֵ߳");
+            args.threads = stoi(argv[++i]);
+            if (args.threads < 0) {
+                throw invalid_argument("߳Ϊ");
+            }
+            if (args.threads == 0) {
+                args.threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+            }
+        }
+        else if (arg == "--warmup") {
+            if (!hasValue) throw invalid_argument("ȱԤȴֵ");
+            args.warmup = max(0, stoi(argv[++i]));
+        }
+        else if (arg == "--reps") {
+            if (!hasValue) throw invalid_argument("ȱظֵ");
+            args.minReps = max(1, stoi(argv[++i]));
+        }
+        else if (arg == "--min-time") {
+            if (!hasValue) throw invalid_argument("ȱʱֵ");
+            args.minTime = max(0.0, stod(argv[++i]));
+        }
+        else if (arg == "--json") {
+            if (!hasValue) throw invalid_argument("ȱJSONļֵ");
+            args.jsonFile = argv[++i];
+        }
+        else if (arg == "-h" || arg == "--help") {
+            cout << "AES׼" << endl;
+            cout << "÷: " << argv[0] << " bench [ѡ]" << endl;
+            cout << "ÿ ģʽ x Կ x  x / x  ϣڴзݣ" << endl;
+            cout << "ÿֽTSC͵εúʱp50/p99" << endl;
+            cout << "ѡбԶŷָ:" << endl;
+            cout << "  -a, --aes-mode   ģʽбĬecb,cbc,cfb,ofb,ctr,gcm,xts512ֽ" << endl;
+            cout << "  -l, --key-length ԿбĬ128,192,256" << endl;
+            cout << "  -b, --backend    бĬportable,ttable,bitsliceԼCPU֧ʱaesni" << endl;
+            cout << "  -m, --mode       encryptdecryptߣĬencrypt,decrypt" << endl;
+            cout << "      --sizes      бɴK/M/G׺Ĭ64,4K,64K,1M" << endl;
+            cout << "  -s, --segment    CFB/OFBֶγ: 8128Ĭ128" << endl;
+            cout << "  -t, --threads    ߳0ʾCPUĬ1" << endl;
+            cout << "      --warmup     ÿԤȵĵôĬ2" << endl;
+            cout << "      --reps       ÿټʱĵôĬ5" << endl;
+            cout << "      --min-time   ÿټʱĺĬ100" << endl;
+            cout << "      --json       ѽJSONдļ-ʾ׼" << endl;
+            exit(0);
+        }
+        else {
+            throw invalid_argument("ЧĲ: " + arg);
+        }
+    }
+    return args;
+}
+
+// һÿεͬһʽ¿ʼһϢsizeֽڲ
+// Կչڴ
+BenchResult benchOne(const BenchArgs& args, const Context& key, AESMode mode, OperationMode op,
+    const vector<uint8_t>& plain, size_t size) {
+    const uint8_t iv[16] = { 0x0f, 0x0e, 0x0d, 0x0c, 0x0b, 0x0a, 0x09, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00 };
+    size_t ivLen = mode == GCM ? 12 : 16;
+    vector<uint8_t> out(size + 32);
+    vector<uint8_t> cipher;
+    unique_ptr<Stream> stream;
+    function<void()> call;
+
+    if (mode == XTS) {
+        // XTS512ֽԿtweakԿʹͬһģֻӰӰٶȣ
+        call = [&]() {
+            xtsCrypt(key, key, 0, 512, plain.data(), out.data(), size, op, args.threads);
+        };
+    }
+    else {
+        StreamOptions options;
+        options.segment = args.segment;
+        options.threads = args.threads;
+        stream = makeStream(key, mode, ENCRYPT, iv, ivLen, options);
+
+        // ܲԵΪͬܵõģ֤֤ǩЧ
+        const uint8_t* in = plain.data();
+        size_t inLen = size;
+        if (op == DECRYPT) {
+            stream->update(plain.data(), size, cipher);
+            stream->finish(cipher);
+            in = cipher.data();
+            inLen = cipher.size();
+            stream = makeStream(key, mode, DECRYPT, iv, ivLen, options);
+        }
 
-        // Կ
-        result.push_back(data[i] ^ encryptedCounter[i % 16]);
+        call = [&, in, inLen]() {
+            stream->reset(iv, ivLen);
+            size_t written = stream->update(in, inLen, out.data());
+            stream->finish(out.data() + written);
+        };
+    }
+
+    for (int i = 0; i < args.warmup; i++) {
+        call();
+    }
+
+    vector<double> times;
+    uint64_t cycles = 0;
+    double total = 0;
+    while (static_cast<int>(times.size()) < args.minReps || total < args.minTime * 1e6) {
+        auto start = steady_clock::now();
+        uint64_t c0 = readCycleCounter();
+        call();
+        uint64_t c1 = readCycleCounter();
+        double ns = duration<double, nano>(steady_clock::now() - start).count();
+        cycles += c1 - c0;
+        total += ns;
+        times.push_back(ns);
     }
 
+    sort(times.begin(), times.end());
+    BenchResult result;
+    result.mode = mode;
+    result.keyLen = key.keyLen;
+    result.backend = key.backend;
+    result.op = op;
+    result.size = size;
+    result.reps = times.size();
+    double bytes = static_cast<double>(size) * times.size();
+    result.mbPerSec = total > 0 ? bytes / total * 1000.0 : 0;
+    result.cyclesPerByte = cycles / bytes;
+    result.p50Us = times[times.size() / 2] / 1000.0;
+    result.p99Us = times[min(times.size() - 1, times.size() * 99 / 100)] / 1000.0;
     return result;
 }
 
+// JSON
+void writeBenchJson(ostream& out, const BenchArgs& args, const vector<BenchResult>& results) {
+    out << fixed << setprecision(3);
+    out << "{" << endl;
+    out << "  \"host\": {\"hardware_threads\": " << thread::hardware_concurrency()
+        << ", \"aesni\": " << (cpuHasAESNI() ? "true" : "false")
+        << ", \"pclmul\": " << (cpuHasPCLMUL() ? "true" : "false")
+        << ", \"cycle_counter\": " << (AES_HAVE_AESNI ? "\"tsc\"" : "null") << "}," << endl;
+    out << "  \"config\": {\"threads\": " << args.threads << ", \"segment\": " << args.segment
+        << ", \"warmup\": " << args.warmup << ", \"min_reps\": " << args.minReps
+        << ", \"min_time_ms\": " << args.minTime << "}," << endl;
+    out << "  \"results\": [" << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"mode\": \"" << modeName(r.mode) << "\", \"key_bits\": " << 128 + 64 * r.keyLen
+            << ", \"backend\": \"" << backendName(r.backend) << "\", \"op\": \"" << (r.op == ENCRYPT ? "encrypt" : "decrypt")
+            << "\", \"size\": " << r.size << ", \"reps\": " << r.reps
+            << ", \"mb_per_s\": " << r.mbPerSec << ", \"cycles_per_byte\": ";
+        if (AES_HAVE_AESNI) {
+            out << r.cyclesPerByte;
+        }
+        else {
+            out << "null";
+        }
+        out << ", \"p50_us\": " << r.p50Us << ", \"p99_us\": " << r.p99Us << "}"
+            << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    out << "  ]" << endl;
+    out << "}" << endl;
+}
+
+// benchڴвϣ׼ѡJSON
+int runBenchmark(int argc, char* argv[]) {
+    BenchArgs args = parseBenchArgs(argc, argv);
+    bool jsonToStdout = args.jsonFile == "-";
+
+    size_t maxSize = *max_element(args.sizes.begin(), args.sizes.end());
+    vector<uint8_t> plain(maxSize);
+    uint32_t seed = 0x9e3779b9;
+    for (uint8_t& b : plain) {
+        seed = seed * 1664525 + 1013904223;
+        b = static_cast<uint8_t>(seed >> 24);
+    }
+    uint8_t rawKey[32];
+    memcpy(rawKey, plain.data(), min<size_t>(32, plain.size()));
+
+    if (!jsonToStdout) {
+        cout << left << setw(5) << "ģʽ" << setw(6) << "Կ" << setw(10) << "" << setw(9) << ""
+            << right << setw(11) << "" << setw(8) << "" << setw(12) << "MB/s"
+            << setw(10) << "/ֽ" << setw(12) << "p50(us)" << setw(12) << "p99(us)" << endl;
+    }
+
+    vector<BenchResult> results;
+    for (AESBackend backend : args.backends) {
+        for (KeyLength keyLen : args.keyLens) {
+            Context key(rawKey, keyLen, backend);
+            for (AESMode mode : args.modes) {
+                for (OperationMode op : args.ops) {
+                    for (size_t size : args.sizes) {
+                        if (mode == XTS && size < 16) {
+                            continue;  // XTSݵԪһ
+                        }
+                        BenchResult r = benchOne(args, key, mode, op, plain, size);
+                        results.push_back(r);
+                        if (!jsonToStdout) {
+                            cout << left << setw(5) << modeName(mode) << setw(6) << 128 + 64 * keyLen
+                                << setw(10) << backendName(r.backend) << setw(9) << (op == ENCRYPT ? "encrypt" : "decrypt")
+                                << right << setw(11) << size << setw(8) << r.reps
+                                << fixed << setprecision(1) << setw(12) << r.mbPerSec
+                                << setprecision(2) << setw(10) << r.cyclesPerByte
+                                << setw(12) << r.p50Us << setw(12) << r.p99Us << endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (jsonToStdout) {
+        writeBenchJson(cout, args, results);
+    }
+    else if (!args.jsonFile.empty()) {
+        ofstream out(args.jsonFile);
+        if (!out) {
+            throw runtime_error("޷ļ: " + args.jsonFile);
+        }
+        writeBenchJson(out, args, results);
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     try {
+        if (argc > 1 && string(argv[1]) == "bench") {
+            return runBenchmark(argc, argv);
+        }
+
         // в
         Args args = parseArgs(argc, argv);
 
-        // ȡļ
-        vector<uint8_t> inputData = readFile(args.inputFile);
-        cout << "ȡļ: " << args.inputFile << " (" << inputData.size() << " ֽ)" << endl;
-
         // ׼ԿչԿ
         int keySize = (args.keyLen == AES_128) ? 16 : (args.keyLen == AES_192) ? 24 : 32;
-        uint8_t key[32];
-        memcpy(key, args.key.data(), keySize);
+        uint8_t key[64];
+        memcpy(key, args.key.data(), args.key.size());
+
+        // ѡչԿ
+        Context expandedKey(key, args.keyLen, args.backend);
+
+        if (args.aesMode == XTS) {
+            // ԿĺһڼţԿչһ
+            Context tweakKey(key + keySize, args.keyLen, args.backend);
+            auto start = high_resolution_clock::now();
+            pair<uint64_t, uint64_t> sizes = xtsFile(args, expandedKey, tweakKey);
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<milliseconds>(end - start);
+
+            const string& outputFile = args.inplace ? args.inputFile : args.outputFile;
+            cout << "ȡļ: " << args.inputFile << " (" << sizes.first << " ֽڣʼλ "
+                << (args.opMode == DECRYPT || args.inplace ? args.offset : 0) << ")" << endl;
+            cout << "дļ: " << outputFile << " (" << sizes.second << " ֽڣʼλ "
+                << (args.opMode == ENCRYPT || args.inplace ? args.offset : 0) << ")" << endl;
+            printSummary(args, expandedKey, duration.count());
+            return 0;
+        }
 
-        // չԿС
-        int wSize = 4 * (ROUNDS[args.keyLen] + 1);
-        uint8_t* w = new uint8_t[wSize * 4]; // ÿ4ֽ
-        keyExpansion(key, w, args.keyLen);
+        if (args.batch) {
+            return processBatch(args, expandedKey) == 0 ? 0 : 1;
+        }
 
         // ׼ʼ
         uint8_t iv[16];
         if (!args.iv.empty()) {
-            memcpy(iv, args.iv.data(), 16);
+            memcpy(iv, args.iv.data(), min(args.iv.size(), sizeof(iv)));
         }
 
-        // ִмӽܲʱ
-        vector<uint8_t> outputData;
-        auto start = high_resolution_clock::now();
+        if (args.byteRange) {
+            // ΧʱλͶд
+            auto start = high_resolution_clock::now();
+            pair<uint64_t, uint64_t> sizes = rangeFile(args, expandedKey, iv);
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<milliseconds>(end - start);
 
-        switch (args.aesMode) {
-        case ECB:
-            if (args.opMode == ENCRYPT) {
-                outputData = ecbEncrypt(inputData, w, args.keyLen);
-            }
-            else {
-                outputData = ecbDecrypt(inputData, w, args.keyLen);
-            }
-            break;
-        case CBC:
-            if (args.opMode == ENCRYPT) {
-                outputData = cbcEncrypt(inputData, w, args.keyLen, iv);
-            }
-            else {
-                outputData = cbcDecrypt(inputData, w, args.keyLen, iv);
-            }
-            break;
-        case CFB:
-            outputData = cfbProcess(inputData, w, args.keyLen, iv);
-            break;
-        case OFB:
-            outputData = ofbProcess(inputData, w, args.keyLen, iv);
-            break;
-        case CTR:
-            outputData = ctrProcess(inputData, w, args.keyLen, iv);
-            break;
+            cout << "ȡļ: " << args.inputFile << " (" << sizes.first << " ֽڣʼλ " << args.rangeStart << ")" << endl;
+            cout << "дļ: " << args.outputFile << " (" << sizes.second << " ֽ)" << endl;
+            printSummary(args, expandedKey, duration.count());
+            return 0;
         }
 
-        auto end = high_resolution_clock::now();
-        auto duration = duration_cast<milliseconds>(end - start);
+        // OFBļʱ˳ɼ㣬Ժ--rangeֱӽһ
+        unique_ptr<OfbCheckpointWriter> checkpoints;
+        OfbCheckpoint checkpoint;
+        if (!args.checkpointFile.empty()) {
+            checkpoints.reset(new OfbCheckpointWriter(args, expandedKey, iv));
+            checkpoint = checkpoints->hook();
+        }
 
-        // дļ
-        writeFile(args.outputFile, outputData);
-        cout << "дļ: " << args.outputFile << " (" << outputData.size() << " ֽ)" << endl;
+        if (args.stream || args.mmap) {
+            // ʽڴӳ䴦ʱI/OӳʱΪȱҳ
+            auto start = high_resolution_clock::now();
+            StreamOptions options;
+            options.segment = args.segment;
+            options.threads = args.threads;
+            options.aad = args.aad;
+            options.checkpoint = checkpoint;
+            unique_ptr<Stream> stream = makeStream(expandedKey, args.aesMode, args.opMode,
+                reinterpret_cast<const uint8_t*>(args.iv.data()), args.iv.size(), options);
+            pair<uint64_t, uint64_t> sizes;
+            try {
+                sizes = args.mmap ? mapFile(args, *stream) : streamFile(args.inputFile, args.outputFile, *stream);
+            }
+            catch (...) {
+                // ߴGCM֤ʧܣʱɾδ֤
+                if (!args.inplace) {
+                    remove(args.outputFile.c_str());
+                }
+                throw;
+            }
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<milliseconds>(end - start);
 
-        // Ϣ
-        cout << ": " << (args.opMode == ENCRYPT ? "" : "") << " " << endl;
-        cout << "AESģʽ: ";
-        switch (args.aesMode) {
-        case ECB: cout << "ECB"; break;
-        case CBC: cout << "CBC"; break;
-        case CFB: cout << "CFB"; break;
-        case OFB: cout << "OFB"; break;
-        case CTR: cout << "CTR"; break;
+            const string& outputFile = args.inplace ? args.inputFile : args.outputFile;
+            cout << "ȡļ: " << args.inputFile << " (" << sizes.first << " ֽ)" << endl;
+            cout << "дļ: " << outputFile << " (" << sizes.second << " ֽ)" << endl;
+            printSummary(args, expandedKey, duration.count());
         }
-        cout << endl;
-        cout << "Կ: " << (args.keyLen == AES_128 ? 128 : (args.keyLen == AES_192 ? 192 : 256)) << "λ" << endl;
-        cout << "ʱ: " << duration.count() << " " << endl;
+        else {
+            // ȡļ
+            vector<uint8_t> inputData = readFile(args.inputFile);
+            cout << "ȡļ: " << args.inputFile << " (" << inputData.size() << " ֽ)" << endl;
 
-        // ڴ
-        delete[] w;
+            // ִмӽܲʱ
+            auto start = high_resolution_clock::now();
+            vector<uint8_t> outputData = processData(inputData, args, expandedKey, iv, checkpoint);
+            auto end = high_resolution_clock::now();
+            auto duration = duration_cast<milliseconds>(end - start);
 
+            // дļ
+            writeFile(args.outputFile, outputData);
+            cout << "дļ: " << args.outputFile << " (" << outputData.size() << " ֽ)" << endl;
+            printSummary(args, expandedKey, duration.count());
+        }
+
+        if (checkpoints) {
+            uint64_t count = checkpoints->close();
+            cout << "ļ: " << args.checkpointFile << " (" << count
+                << "  " << args.checkpointInterval << " ֽ)" << endl;
+        }
     }
     catch (const exception& e) {
         cerr << ": " << e.what() << endl;
@@ -771,3 +4236,5 @@ int main(int argc, char* argv[]) {
 
     return 0;
 }
+
+#endif  // AES_NO_MAIN
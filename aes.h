@@ -0,0 +1,211 @@
+#ifndef AES_H
+#define AES_H
+
+// AESӽܿӿڣ
+//   aes::Context  ԿһչõԿֻڶ̼߳乲
+//   aes::Stream   ģʽʽӽܶupdate/finishresetظʹ
+//   aes::xtsCrypt ʵXTSӽ
+// aes.cppʱAES_NO_MAINȥйߣֻӿⲿ
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace aes {
+
+// AESֵ֧Կ
+enum KeyLength {
+    AES_128,  // 128λԿ
+    AES_192,  // 192λԿ
+    AES_256   // 256λԿ
+};
+
+// AESģʽ
+enum AESMode {
+    ECB,    // 뱾ģʽ
+    CBC,    // ģʽ
+    CFB,    // 뷴ģʽ
+    OFB,    // ģʽ
+    CTR,    // ģʽ
+    GCM,    // ٤/ģʽ֤
+    XTS     // ܵXEXģʽIEEE 1619ڴ̾
+};
+
+// ģʽ
+enum OperationMode {
+    ENCRYPT,
+    DECRYPT
+};
+
+// ܺ
+enum AESBackend {
+    BACKEND_AUTO,      // ʱԶѡ
+    BACKEND_PORTABLE,  // ֽڲοʵ
+    BACKEND_TTABLE,    // 32λTʵ
+    BACKEND_BITSLICE,  // 64λλƬʵ֣ʱ䣩
+    BACKEND_AESNI      // AES-NIӲָ
+};
+
+// ԿģʱѡչüӽԿֻ֮ɱ߳ͬʱʹá
+// ڴ棬ԷջϻΪĳԱ
+struct Context {
+    // keyΪ16/24/32ֽڵԭʼԿѡ˲ʱ׳runtime_error
+    Context(const uint8_t* key, KeyLength keyLen, AESBackend backend = BACKEND_AUTO);
+
+    // /n໥16ֽڿ飨ECB䣩inoutͬ
+    void encrypt_blocks(const uint8_t* in, uint8_t* out, size_t n) const;
+    void decrypt_blocks(const uint8_t* in, uint8_t* out, size_t n) const;
+
+    KeyLength keyLen;
+    int rounds;
+    AESBackend backend;    // ʵʹõĺˣBACKEND_AUTO
+    uint8_t w[240];        // ֽʽչԿοʵ֡λƬ
+    uint32_t ek[60];       // TԿ
+    uint32_t dk[60];       // TԿ
+    uint64_t bsRk[15][8];  // λƬԿ
+    alignas(16) uint8_t niEk[240];  // AES-NIԿ
+    alignas(16) uint8_t niDk[240];  // AES-NIԿ
+};
+
+// OFB㣺ÿintervalֽڣѴֽʹʱļĴֵһcallback
+struct OfbCheckpoint {
+    uint64_t interval;  // 16ı0ʾ¼
+    std::function<void(uint64_t position, const uint8_t* registerValue)> callback;
+
+    OfbCheckpoint() : interval(0) {}
+};
+
+// ʽѡ
+struct StreamOptions {
+    int segment;      // CFB/OFBֶγȣλ8128
+    int threads;      // ECBCBCܡCFB-128ܺCTRʹõ߳
+    std::string aad;  // GCM֤
+    OfbCheckpoint checkpoint;  // OFBص
+
+    StreamOptions() : segment(128), threads(1) {}
+};
+
+// ʽӽܣɰⳤȷֶ룬ģʽ״ֵ̬Ĵ
+// δһݣڸ֮䱣֣ڴռܳ޹
+class Stream {
+public:
+    // holdBytesΪupdateʱfinishĩβֽȥģʽΪ1һ飩GCMΪǩ
+    explicit Stream(size_t holdBytes) : pendingLen(0), holdBytes(holdBytes) {}
+    virtual ~Stream() {}
+
+    // һ룬дoutoutputSize(len)ֽڣдֽ
+    // ûδʱoutinͬԭش
+    size_t update(const uint8_t* in, size_t len, uint8_t* out) {
+        size_t ready = outputSize(len);
+        size_t written = ready;
+
+        // ȴϴµݣһʱݲ
+        while (ready > 0 && pendingLen > 0) {
+            if (pendingLen >= 16) {
+                processBlocks(pending, out, 1);
+                pendingLen -= 16;
+                memmove(pending, pending + 16, pendingLen);
+            }
+            else {
+                size_t fill = 16 - pendingLen;
+                memcpy(pending + pendingLen, in, fill);
+                processBlocks(pending, out, 1);
+                in += fill;
+                len -= fill;
+                pendingLen = 0;
+            }
+            out += 16;
+            ready -= 16;
+        }
+
+        // ֱӴ봦ʣಿ´
+        processBlocks(in, out, ready / 16);
+        if (len > ready) {
+            memcpy(pending + pendingLen, in + ready, len - ready);
+            pendingLen += len - ready;
+        }
+        return written;
+    }
+
+    // һ룬׷ӵout
+    void update(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
+        size_t base = out.size();
+        out.resize(base + outputSize(len));
+        update(in, len, out.data() + base);
+    }
+
+    // ʣݣ䡢ȥ䡢һ֤ǩдout32ֽڣдֽ
+    size_t finish(uint8_t* out) {
+        size_t written = processTail(pending, pendingLen, out);
+        pendingLen = 0;
+        return written;
+    }
+
+    // ʣݣ׷ӵout
+    void finish(std::vector<uint8_t>& out) {
+        size_t base = out.size();
+        out.resize(base + 32);
+        out.resize(base + finish(out.data() + base));
+    }
+
+    // lenֽʱupdateдֽ
+    size_t outputSize(size_t len) const {
+        // Ҫȥģʽһ飬ֱfinishʱȷǷһ
+        size_t total = pendingLen + len;
+        return total <= holdBytes ? 0 : (total - holdBytes) / 16 * 16;
+    }
+
+    // δݣµĳʼʼһϢͬһɷʹã´
+    void reset(const uint8_t* iv, size_t ivLen) {
+        pendingLen = 0;
+        restart(iv, ivLen);
+    }
+
+protected:
+    // n
+    virtual void processBlocks(const uint8_t* in, uint8_t* out, size_t n) = 0;
+    // ʣµlenֽڣ16 + holdBytesдֽ
+    virtual size_t processTail(const uint8_t* in, size_t len, uint8_t* out) = 0;
+    // ʼùģʽ״̬
+    virtual void restart(const uint8_t* iv, size_t ivLen) = 0;
+
+    // ߺһܽ䣬ȥĳ
+    static size_t unpaddedSize(const uint8_t* block) {
+        size_t paddingSize = block[15];
+        if (paddingSize > 16) {
+            throw std::runtime_error("Ч");
+        }
+        return 16 - paddingSize;
+    }
+
+    // ߺPKCS#7һ
+    static void padBlock(const uint8_t* in, size_t len, uint8_t* block) {
+        memcpy(block, in, len);
+        memset(block + len, static_cast<int>(16 - len), 16 - len);
+    }
+
+private:
+    uint8_t pending[32];
+    size_t pendingLen;
+    size_t holdBytes;
+};
+
+// ʽӽܶXTS⣩ivECBԣGCMΪ㳤ȣƼ12ֽڣģʽΪ16ֽڣ
+// صĶkeykeyڵø
+std::unique_ptr<Stream> makeStream(const Context& key, AESMode mode, OperationMode op,
+    const uint8_t* iv, size_t ivLen, const StreamOptions& options = StreamOptions());
+
+// XTSӽܴӵsectorʼlenֽڣ໥ֻеһΡ
+// dataKeytweakKeyΪͬԿģsectorSizeΪ16ı
+// һԲ16ֽڣŲôinoutͬ
+void xtsCrypt(const Context& dataKey, const Context& tweakKey, uint64_t sector, size_t sectorSize,
+    const uint8_t* in, uint8_t* out, size_t len, OperationMode op, int threads = 1);
+
+}  // namespace aes
+
+#endif
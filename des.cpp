@@ -10,6 +10,32 @@
 #include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <array>
+#include <memory>
+#include <cstdio>
+
+// ֽתСϰд64λֻһֶдһֽڽָ
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#define DES_LITTLE_ENDIAN 1
+#define DES_BSWAP64(x) _byteswap_uint64(x)
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DES_LITTLE_ENDIAN 1
+#define DES_BSWAP64(x) __builtin_bswap64(x)
+#else
+#define DES_LITTLE_ENDIAN 0
+#endif
+
+// x86/x64ƽ̨λƬʹ128λSSE2Ĵ
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DES_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define DES_HAVE_SSE2 0
+#endif
 
 using namespace std;
 using namespace chrono;
@@ -28,18 +54,42 @@ enum OperationMode {
     DECRYPT
 };
 
+// 
+enum DESVariant {
+    DES_SINGLE,  // DES8ֽԿ
+    TDES_EDE2,   // 3DES˫Կ(K1, K2, K1)16ֽԿ
+    TDES_EDE3    // 3DESԿ(K1, K2, K3)24ֽԿ
+};
+
+// ܺ
+enum DESBackend {
+    DES_BACKEND_AUTO,      // Զѡ
+    DES_BACKEND_TABLE,     // ʵ(SP)
+    DES_BACKEND_BITSLICE   // λƬʵ֣ʱһ64(SSE2128)ʱ
+};
+
 // вṹ
 struct Args {
     OperationMode opMode;
     DESMode desMode;
-    string key;       // 8ֽԿ
+    DESVariant variant;
+    DESBackend backend;
+    string key;       // 8ֽԿ(3DESΪ1624ֽ)
     string iv;        // 8ֽڳʼ(ģʽҪ)
     string inputFile;
     string outputFile;
+    int segment;      // CFB/OFBֶγ(λ)
+    int threads;      // ECBCBCܺCFB-64ʹõ߳Կ߳
+    bool search;      // ֪Կ
+    string knownPlain;      // ֪Ŀ(16ʮַ)
+    string knownCipher;     // ӦĿ
+    string charset;         // δַַ֪
+    string prefix;          // ֪Կǰ׺
+    string checkpointFile;  // ļ
 };
 
 // DES - ʼû(IP)
-const int IP[] = {
+constexpr int IP[] = {
     58, 50, 42, 34, 26, 18, 10, 2,
     60, 52, 44, 36, 28, 20, 12, 4,
     62, 54, 46, 38, 30, 22, 14, 6,
@@ -51,7 +101,7 @@ const int IP[] = {
 };
 
 // ʼû(IP^-1)
-const int IP_INV[] = {
+constexpr int IP_INV[] = {
     40, 8, 48, 16, 56, 24, 64, 32,
     39, 7, 47, 15, 55, 23, 63, 31,
     38, 6, 46, 14, 54, 22, 62, 30,
@@ -62,8 +112,9 @@ const int IP_INV[] = {
     33, 1, 41, 9, 49, 17, 57, 25
 };
 
-// չû(E)
-const int E[] = {
+// չû(E)i6λǡRӵ4iλ(1ʼ032λ)6λ
+// ʵѭλλչeChunk
+constexpr int E[] = {
     32, 1, 2, 3, 4, 5,
     4, 5, 6, 7, 8, 9,
     8, 9, 10, 11, 12, 13,
@@ -75,7 +126,7 @@ const int E[] = {
 };
 
 // ûP
-const int P[] = {
+constexpr int P[] = {
     16, 7, 20, 21, 29, 12, 28, 17,
     1, 15, 23, 26, 5, 18, 31, 10,
     2, 8, 24, 14, 32, 27, 3, 9,
@@ -83,7 +134,7 @@ const int P[] = {
 };
 
 // S
-const int S[8][4][16] = {
+constexpr int S[8][4][16] = {
     {
         {14,4,13,1,2,15,11,8,3,10,6,12,5,9,0,7},
         {0,15,7,4,14,2,13,1,10,6,12,11,9,5,3,8},
@@ -135,7 +186,7 @@ const int S[8][4][16] = {
 };
 
 // ԿûPC-1
-const int PC1[] = {
+constexpr int PC1[] = {
     57, 49, 41, 33, 25, 17, 9,
     1, 58, 50, 42, 34, 26, 18,
     10, 2, 59, 51, 43, 35, 27,
@@ -147,7 +198,7 @@ const int PC1[] = {
 };
 
 // ԿûPC-2
-const int PC2[] = {
+constexpr int PC2[] = {
     14, 17, 11, 24, 1, 5, 3, 28,
     15, 6, 21, 10, 23, 19, 12, 4,
     26, 8, 16, 7, 27, 20, 13, 2,
@@ -157,19 +208,7 @@ const int PC2[] = {
 };
 
 // ѭλ
-const int SHIFT[] = { 1,1,2,2,2,2,2,2,1,2,2,2,2,2,2,1 };
-
-// ߺ64λݰûû
-uint64_t permute(uint64_t data, const int* table, int tableSize) {
-    uint64_t result = 0;
-    for (int i = 0; i < tableSize; i++) {
-        // ȡtable[i]λ(1ʼ)
-        uint64_t bit = (data >> (64 - table[i])) & 1;
-        // ĵ(64 - i)λ
-        result |= (bit << (63 - i));
-    }
-    return result;
-}
+constexpr int SHIFT[] = { 1,1,2,2,2,2,2,2,1,2,2,2,2,2,2,1 };
 
 // ߺѭ
 uint64_t leftShift(uint64_t data, int bits, int totalBits) {
@@ -214,83 +253,197 @@ vector<uint64_t> generateSubkeys(uint64_t key) {
     return subkeys;
 }
 
-// F
-uint32_t fFunction(uint32_t R, uint64_t subkey) {
-    // չû(32λ->48λ)
-    uint64_t expanded = 0;
-    for (int i = 0; i < 48; i++) {
-        uint64_t bit = (R >> (32 - E[i])) & 1;
-        expanded |= (bit << (47 - i));
+// Կţÿ48λԿԤȲ86λ(SһһӦ)ܡźã
+// ֱֺӰ±ȡãλ±㡣ṹǡռ4
+struct alignas(64) DesKeySchedule {
+    uint8_t enc[16][8];  // 
+    uint8_t dec[16][8];  // (enc)
+};
+
+// 64λԿԿ
+DesKeySchedule makeKeySchedule(uint64_t key) {
+    vector<uint64_t> subkeys = generateSubkeys(key);
+    DesKeySchedule schedule;
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j < 8; j++) {
+            uint8_t chunk = static_cast<uint8_t>((subkeys[i] >> (42 - j * 6)) & 0x3F);
+            schedule.enc[i][j] = chunk;
+            schedule.dec[15 - i][j] = chunk;
+        }
     }
+    return schedule;
+}
 
-    // Կ
-    expanded ^= subkey;
+// 32λѭ
+constexpr uint32_t rotr32(uint32_t x, int n) {
+    return (x >> (n & 31)) | (x << ((32 - n) & 31));
+}
+
+// չûEĵi6λ(i = 0..7)Rѭƺȡ6λɣҪλչ
+constexpr uint32_t eChunk(uint32_t R, int i) {
+    return rotr32(R, 27 - 4 * i) & 0x3F;
+}
 
-    // S滻(48λ->32λ)
-    uint32_t sOutput = 0;
+// ڼeChunkչûEһ
+constexpr bool checkEChunk() {
     for (int i = 0; i < 8; i++) {
-        // ÿSд6λ
-        uint64_t block = (expanded >> (42 - i * 6)) & 0x3F;
+        for (int j = 0; j < 6; j++) {
+            uint32_t R = 1u << (32 - E[i * 6 + j]);
+            if (eChunk(R, i) != (1u << (5 - j))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(checkEChunk(), "eChunkչûEһ");
 
-        // к
-        int row = ((block >> 5) & 1) << 1 | (block & 1);
-        int col = (block >> 1) & 0x0F;
+// ֽڲ64λût[j][v]Ϊjֽ(Ӹλ)ȡֵvʱڽλı
+struct PermTable {
+    uint64_t t[8][256];
+};
 
-        // Sлȡֵ(4λ)
-        uint32_t val = S[i][row][col];
-        sOutput |= (val << (28 - i * 4));
+// ûֽڲinv[p - 1]Ϊpλڽеλ(1ʼ)
+constexpr PermTable makePermTable(const int* inv) {
+    PermTable table = {};
+    for (int j = 0; j < 8; j++) {
+        for (int v = 0; v < 256; v++) {
+            uint64_t out = 0;
+            for (int b = 0; b < 8; b++) {
+                if (v & (0x80 >> b)) {
+                    out |= 1ULL << (64 - inv[j * 8 + b]);
+                }
+            }
+            table.t[j][v] = out;
+        }
     }
+    return table;
+}
 
-    // Pû
-    uint32_t pOutput = 0;
-    for (int i = 0; i < 32; i++) {
-        uint32_t bit = (sOutput >> (32 - P[i])) & 1;
-        pOutput |= (bit << (31 - i));
-    }
+// IPIP^-1ΪûԵǶԷ
+constexpr PermTable IP_TABLE = makePermTable(IP_INV);
+constexpr PermTable FP_TABLE = makePermTable(IP);
 
-    return pOutput;
+// ֽڲ64λû
+inline uint64_t permuteBytes(uint64_t data, const PermTable& table) {
+    return table.t[0][data >> 56] | table.t[1][(data >> 48) & 0xFF] |
+        table.t[2][(data >> 40) & 0xFF] | table.t[3][(data >> 32) & 0xFF] |
+        table.t[4][(data >> 24) & 0xFF] | table.t[5][(data >> 16) & 0xFF] |
+        table.t[6][(data >> 8) & 0xFF] | table.t[7][data & 0xFF];
 }
 
-// DES
-uint64_t desBlockEncrypt(uint64_t block, const vector<uint64_t>& subkeys) {
-    // ʼû
-    uint64_t permuted = permute(block, IP, 64);
+// ϲSPûSPsp[i][x]ΪiS6λxʱPû32λ
+// еĲҲѾչ±
+struct SPTable {
+    uint32_t sp[8][64];
+};
 
-    // ֳ
-    uint32_t L = (permuted >> 32) & 0xFFFFFFFF;
-    uint32_t R = permuted & 0xFFFFFFFF;
+constexpr SPTable makeSPTable() {
+    // PûSpλڽеλ
+    int pInv[32] = {};
+    for (int i = 0; i < 32; i++) {
+        pInv[P[i] - 1] = i + 1;
+    }
 
-    // 16ֵ
-    for (int i = 0; i < 16; i++) {
-        uint32_t temp = R;
-        R = L ^ fFunction(R, subkeys[i]);
-        L = temp;
+    SPTable table = {};
+    for (int i = 0; i < 8; i++) {
+        for (int x = 0; x < 64; x++) {
+            int row = ((x >> 4) & 2) | (x & 1);
+            int col = (x >> 1) & 0x0F;
+            int val = S[i][row][col];
+            uint32_t out = 0;
+            for (int b = 0; b < 4; b++) {
+                if (val & (8 >> b)) {
+                    out |= 1u << (32 - pInv[i * 4 + b]);
+                }
+            }
+            table.sp[i][x] = out;
+        }
     }
+    return table;
+}
+
+constexpr SPTable SP = makeSPTable();
+
+// һֵL ^= F(R, K)չûѭλSPûϲΪ8β
+// kΪֲõ8Կ
+inline void desRound(uint32_t& L, uint32_t R, const uint8_t* k) {
+    L ^= SP.sp[0][eChunk(R, 0) ^ k[0]] ^ SP.sp[1][eChunk(R, 1) ^ k[1]] ^
+        SP.sp[2][eChunk(R, 2) ^ k[2]] ^ SP.sp[3][eChunk(R, 3) ^ k[3]] ^
+        SP.sp[4][eChunk(R, 4) ^ k[4]] ^ SP.sp[5][eChunk(R, 5) ^ k[5]] ^
+        SP.sp[6][eChunk(R, 6) ^ k[6]] ^ SP.sp[7][eChunk(R, 7) ^ k[7]];
+}
 
-    // ֲгʼûû
-    uint64_t combined = ((uint64_t)R << 32) | L;
-    return permute(combined, IP_INV, 64);
+// 16ֵLRΪʼû룬kΪDesKeyScheduleencdec
+// ȫչ£Ҫÿֽ16ֺLRǡΪL16R16
+// ʱ룬õû֮ǰֱΪһDES(IPIP^-1໥)
+inline void desRounds(uint32_t& L, uint32_t& R, const uint8_t (*k)[8]) {
+    desRound(L, R, k[0]);
+    desRound(R, L, k[1]);
+    desRound(L, R, k[2]);
+    desRound(R, L, k[3]);
+    desRound(L, R, k[4]);
+    desRound(R, L, k[5]);
+    desRound(L, R, k[6]);
+    desRound(R, L, k[7]);
+    desRound(L, R, k[8]);
+    desRound(R, L, k[9]);
+    desRound(L, R, k[10]);
+    desRound(R, L, k[11]);
+    desRound(L, R, k[12]);
+    desRound(R, L, k[13]);
+    desRound(L, R, k[14]);
+    desRound(R, L, k[15]);
+
+    uint32_t temp = L;
+    L = R;
+    R = temp;
 }
 
-// DES
-uint64_t desBlockDecrypt(uint64_t block, const vector<uint64_t>& subkeys) {
-    // ʼû
-    uint64_t permuted = permute(block, IP, 64);
+// ͬʱN໥Ŀ16ֵĲУ
+// һȴʱִָ
+template <int N>
+inline void desRoundsN(uint32_t* L, uint32_t* R, const uint8_t (*k)[8]) {
+    for (int i = 0; i < 16; i += 2) {
+        for (int j = 0; j < N; j++) {
+            desRound(L[j], R[j], k[i]);
+        }
+        for (int j = 0; j < N; j++) {
+            desRound(R[j], L[j], k[i + 1]);
+        }
+    }
 
-    // ֳ
-    uint32_t L = (permuted >> 32) & 0xFFFFFFFF;
-    uint32_t R = permuted & 0xFFFFFFFF;
+    for (int j = 0; j < N; j++) {
+        uint32_t temp = L[j];
+        L[j] = R[j];
+        R[j] = temp;
+    }
+}
 
-    // 16ֵ(ʹԿ)
-    for (int i = 15; i >= 0; i--) {
-        uint32_t temp = R;
-        R = L ^ fFunction(R, subkeys[i]);
-        L = temp;
+// д64λ
+inline uint64_t loadBE64(const uint8_t* p) {
+#if DES_LITTLE_ENDIAN
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return DES_BSWAP64(v);
+#else
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v = (v << 8) | p[i];
     }
+    return v;
+#endif
+}
 
-    // ֲгʼûû
-    uint64_t combined = ((uint64_t)R << 32) | L;
-    return permute(combined, IP_INV, 64);
+inline void storeBE64(uint8_t* p, uint64_t v) {
+#if DES_LITTLE_ENDIAN
+    v = DES_BSWAP64(v);
+    memcpy(p, &v, 8);
+#else
+    for (int i = 0; i < 8; i++) {
+        p[i] = static_cast<uint8_t>(v >> (56 - 8 * i));
+    }
+#endif
 }
 
 // ַתΪ64λԿ
@@ -306,11 +459,1140 @@ uint64_t stringToKey(const string& keyStr) {
     return key;
 }
 
+// ===== λƬʵ =====
+// Ѷͬһλռһ(λƽ)롢򡢷ͬʱп飺
+// ûֻλƽ±ţҪ㣻Sŵ·㣬ûв
+// ʱݺԿ޹ءÿʹòͬԿԿҲֱʹ
+
+// Sŵ·a1..a6ΪS6λ(a1Ϊλ)o1..o4Ϊ4λ(o1Ϊλ)
+// SֵɣٵһλSв44뺯
+// ÿ4뺯ȡٵĹʽٺϲʽͬӱʽƽԼ90
+template <typename Lane>
+inline void desSbox1(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a4 & a5;
+    Lane x2 = a5 ^ a6;
+    Lane x3 = x1 | x2;
+    Lane x4 = a2 ^ x3;
+    Lane x5 = ~x4;
+    Lane x6 = a2 | a4;
+    Lane x7 = a4 & x2;
+    Lane x8 = x6 ^ x7;
+    Lane x9 = ~x8;
+    Lane x10 = a3 & x9;
+    Lane x11 = a4 ^ a6;
+    Lane x12 = a2 & x11;
+    Lane x13 = ~a4;
+    Lane x14 = a6 | x13;
+    Lane x15 = a5 ^ x14;
+    Lane x16 = x12 | x15;
+    Lane x17 = a1 & x16;
+    Lane x18 = a1 & a3;
+    Lane x19 = a4 & a6;
+    Lane x20 = a4 ^ a5;
+    Lane x21 = a2 ^ x20;
+    Lane x22 = a2 & a6;
+    Lane x23 = a4 ^ x22;
+    Lane x24 = x21 | x23;
+    Lane x25 = x19 ^ x24;
+    Lane x26 = x18 & x25;
+    Lane x27 = x10 ^ x5;
+    Lane x28 = x17 ^ x27;
+    Lane x29 = x26 ^ x28;
+    Lane x30 = a2 ^ x2;
+    Lane x31 = a5 ^ x6;
+    Lane x32 = x30 | x31;
+    Lane x33 = a5 ^ x32;
+    Lane x34 = a4 ^ x33;
+    Lane x35 = ~x34;
+    Lane x36 = a4 | a5;
+    Lane x37 = a2 ^ x36;
+    Lane x38 = a6 & x37;
+    Lane x39 = a5 ^ x38;
+    Lane x40 = ~x39;
+    Lane x41 = a3 & x40;
+    Lane x42 = a2 | a5;
+    Lane x43 = x1 | x22;
+    Lane x44 = x42 ^ x43;
+    Lane x45 = a6 ^ x44;
+    Lane x46 = a1 & x45;
+    Lane x47 = a5 & a6;
+    Lane x48 = a4 | x47;
+    Lane x49 = ~a2;
+    Lane x50 = x20 | x49;
+    Lane x51 = a6 | x50;
+    Lane x52 = x48 ^ x51;
+    Lane x53 = x18 & x52;
+    Lane x54 = x35 ^ x41;
+    Lane x55 = x46 ^ x54;
+    Lane x56 = x53 ^ x55;
+    Lane x57 = a4 ^ x2;
+    Lane x58 = a4 & x42;
+    Lane x59 = a2 ^ x58;
+    Lane x60 = x57 | x59;
+    Lane x61 = a2 ^ x60;
+    Lane x62 = ~x61;
+    Lane x63 = a4 | a6;
+    Lane x64 = a5 ^ x63;
+    Lane x65 = a2 | x64;
+    Lane x66 = a3 & x65;
+    Lane x67 = a2 & x63;
+    Lane x68 = a6 ^ x67;
+    Lane x69 = a5 | x68;
+    Lane x70 = a6 ^ x69;
+    Lane x71 = a2 ^ x70;
+    Lane x72 = ~x71;
+    Lane x73 = a1 & x72;
+    Lane x74 = a2 ^ a4;
+    Lane x75 = a6 & x74;
+    Lane x76 = a2 ^ x75;
+    Lane x77 = x20 | x76;
+    Lane x78 = a5 ^ x77;
+    Lane x79 = x18 & x78;
+    Lane x80 = x62 ^ x66;
+    Lane x81 = x73 ^ x80;
+    Lane x82 = x79 ^ x81;
+    Lane x83 = a2 & x2;
+    Lane x84 = a4 | x83;
+    Lane x85 = x47 ^ x84;
+    Lane x86 = a2 ^ x85;
+    Lane x87 = a5 | x22;
+    Lane x88 = a3 & x87;
+    Lane x89 = a4 ^ x42;
+    Lane x90 = a2 ^ x89;
+    Lane x91 = x11 | x90;
+    Lane x92 = a1 & x91;
+    Lane x93 = a2 ^ a5;
+    Lane x94 = a4 ^ x75;
+    Lane x95 = x93 | x94;
+    Lane x96 = ~x95;
+    Lane x97 = x18 & x96;
+    Lane x98 = x86 ^ x88;
+    Lane x99 = x92 ^ x98;
+    Lane x100 = x97 ^ x99;
+    o1 = x29;
+    o2 = x56;
+    o3 = x82;
+    o4 = x100;
+}
+
+template <typename Lane>
+inline void desSbox2(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = ~a6;
+    Lane x2 = a2 | a5;
+    Lane x3 = a1 & x2;
+    Lane x4 = a2 ^ x3;
+    Lane x5 = x1 | x4;
+    Lane x6 = a5 ^ x5;
+    Lane x7 = a1 ^ x6;
+    Lane x8 = ~a1;
+    Lane x9 = a6 | x8;
+    Lane x10 = a5 & x9;
+    Lane x11 = a2 | x10;
+    Lane x12 = a4 & x11;
+    Lane x13 = a1 ^ a6;
+    Lane x14 = a2 ^ a5;
+    Lane x15 = a1 & x14;
+    Lane x16 = a2 ^ x15;
+    Lane x17 = ~x16;
+    Lane x18 = x13 | x17;
+    Lane x19 = a3 & x18;
+    Lane x20 = x12 ^ x7;
+    Lane x21 = x19 ^ x20;
+    Lane x22 = a5 ^ a6;
+    Lane x23 = a2 ^ x22;
+    Lane x24 = a1 ^ x23;
+    Lane x25 = ~x24;
+    Lane x26 = a1 & a2;
+    Lane x27 = x14 | x26;
+    Lane x28 = ~x27;
+    Lane x29 = a6 | x28;
+    Lane x30 = a5 ^ x29;
+    Lane x31 = a4 & x30;
+    Lane x32 = a2 & a5;
+    Lane x33 = a1 & x32;
+    Lane x34 = a6 | x33;
+    Lane x35 = a2 ^ x34;
+    Lane x36 = a3 & x35;
+    Lane x37 = a3 & a4;
+    Lane x38 = a5 & a6;
+    Lane x39 = x37 & x38;
+    Lane x40 = x25 ^ x31;
+    Lane x41 = x36 ^ x40;
+    Lane x42 = x39 ^ x41;
+    Lane x43 = a2 ^ a6;
+    Lane x44 = a1 & x43;
+    Lane x45 = a2 & a6;
+    Lane x46 = x14 | x45;
+    Lane x47 = a1 ^ x46;
+    Lane x48 = x44 | x47;
+    Lane x49 = ~x48;
+    Lane x50 = a1 | x45;
+    Lane x51 = x14 & x50;
+    Lane x52 = ~x51;
+    Lane x53 = a4 & x52;
+    Lane x54 = a1 & a5;
+    Lane x55 = a2 & x13;
+    Lane x56 = x54 | x55;
+    Lane x57 = a5 ^ x56;
+    Lane x58 = a1 ^ x57;
+    Lane x59 = a3 & x58;
+    Lane x60 = a1 | x23;
+    Lane x61 = a2 ^ x60;
+    Lane x62 = ~x61;
+    Lane x63 = x37 & x62;
+    Lane x64 = x49 ^ x53;
+    Lane x65 = x59 ^ x64;
+    Lane x66 = x63 ^ x65;
+    Lane x67 = a1 ^ a2;
+    Lane x68 = x13 & x67;
+    Lane x69 = x54 | x68;
+    Lane x70 = ~x69;
+    Lane x71 = a6 | x67;
+    Lane x72 = a1 ^ x71;
+    Lane x73 = x14 & x72;
+    Lane x74 = a2 ^ x73;
+    Lane x75 = ~x74;
+    Lane x76 = a4 & x75;
+    Lane x77 = a1 | a5;
+    Lane x78 = ~x77;
+    Lane x79 = x22 & x43;
+    Lane x80 = x78 | x79;
+    Lane x81 = a6 ^ x80;
+    Lane x82 = a3 & x81;
+    Lane x83 = x70 ^ x76;
+    Lane x84 = x82 ^ x83;
+    o1 = x21;
+    o2 = x42;
+    o3 = x66;
+    o4 = x84;
+}
+
+template <typename Lane>
+inline void desSbox3(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a3 ^ a5;
+    Lane x2 = ~a2;
+    Lane x3 = a6 | x2;
+    Lane x4 = a3 & x3;
+    Lane x5 = x1 | x4;
+    Lane x6 = a2 ^ x5;
+    Lane x7 = ~x6;
+    Lane x8 = a2 & a5;
+    Lane x9 = a6 | x8;
+    Lane x10 = a5 & a6;
+    Lane x11 = a2 ^ x10;
+    Lane x12 = a3 | x11;
+    Lane x13 = x12 ^ x9;
+    Lane x14 = a5 ^ x13;
+    Lane x15 = a4 & x14;
+    Lane x16 = a3 & a5;
+    Lane x17 = a2 | a3;
+    Lane x18 = a6 ^ x17;
+    Lane x19 = x16 | x18;
+    Lane x20 = a1 & x19;
+    Lane x21 = a1 & a4;
+    Lane x22 = ~x14;
+    Lane x23 = x21 & x22;
+    Lane x24 = x15 ^ x7;
+    Lane x25 = x20 ^ x24;
+    Lane x26 = x23 ^ x25;
+    Lane x27 = ~a6;
+    Lane x28 = a2 & x27;
+    Lane x29 = a5 | x28;
+    Lane x30 = a3 | x29;
+    Lane x31 = a6 ^ x30;
+    Lane x32 = a5 ^ x31;
+    Lane x33 = a2 ^ x32;
+    Lane x34 = a2 & a3;
+    Lane x35 = a2 ^ a5;
+    Lane x36 = a6 | x35;
+    Lane x37 = x34 ^ x36;
+    Lane x38 = a4 & x37;
+    Lane x39 = a5 | x3;
+    Lane x40 = a3 | x39;
+    Lane x41 = a1 & x40;
+    Lane x42 = a3 ^ x12;
+    Lane x43 = x21 & x42;
+    Lane x44 = x33 ^ x38;
+    Lane x45 = x41 ^ x44;
+    Lane x46 = x43 ^ x45;
+    Lane x47 = ~a4;
+    Lane x48 = ~a1;
+    Lane x49 = x1 & x36;
+    Lane x50 = a6 ^ x49;
+    Lane x51 = a2 ^ x50;
+    Lane x52 = ~x51;
+    Lane x53 = x47 & x52;
+    Lane x54 = a2 | x27;
+    Lane x55 = a5 & x54;
+    Lane x56 = a3 ^ x55;
+    Lane x57 = a4 & x56;
+    Lane x58 = x53 | x57;
+    Lane x59 = a3 | a6;
+    Lane x60 = a2 | x59;
+    Lane x61 = a6 ^ x60;
+    Lane x62 = a5 ^ x61;
+    Lane x63 = a3 ^ x62;
+    Lane x64 = x47 & x63;
+    Lane x65 = a2 | a6;
+    Lane x66 = a3 ^ x65;
+    Lane x67 = x1 & x66;
+    Lane x68 = x10 ^ x67;
+    Lane x69 = a2 ^ x68;
+    Lane x70 = a4 & x69;
+    Lane x71 = x64 | x70;
+    Lane x72 = x48 & x58;
+    Lane x73 = a1 & x71;
+    Lane x74 = x72 | x73;
+    Lane x75 = a6 ^ x16;
+    Lane x76 = a2 ^ x75;
+    Lane x77 = ~a5;
+    Lane x78 = a4 & x77;
+    Lane x79 = a3 ^ a6;
+    Lane x80 = a2 | x79;
+    Lane x81 = a6 ^ x80;
+    Lane x82 = x1 | x81;
+    Lane x83 = a6 ^ x82;
+    Lane x84 = ~x83;
+    Lane x85 = a1 & x84;
+    Lane x86 = ~x34;
+    Lane x87 = a6 & x86;
+    Lane x88 = a5 ^ x87;
+    Lane x89 = x21 & x88;
+    Lane x90 = x76 ^ x78;
+    Lane x91 = x85 ^ x90;
+    Lane x92 = x89 ^ x91;
+    o1 = x26;
+    o2 = x46;
+    o3 = x74;
+    o4 = x92;
+}
+
+template <typename Lane>
+inline void desSbox4(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a5 ^ a6;
+    Lane x2 = a1 & a5;
+    Lane x3 = a3 | x2;
+    Lane x4 = a5 ^ x3;
+    Lane x5 = x1 | x4;
+    Lane x6 = a3 ^ x5;
+    Lane x7 = a1 ^ x6;
+    Lane x8 = a1 & a3;
+    Lane x9 = a5 | x8;
+    Lane x10 = a1 ^ x9;
+    Lane x11 = a6 | x10;
+    Lane x12 = a5 ^ x11;
+    Lane x13 = ~x12;
+    Lane x14 = a4 & x13;
+    Lane x15 = a1 | a3;
+    Lane x16 = ~x15;
+    Lane x17 = a5 & x16;
+    Lane x18 = a6 | x17;
+    Lane x19 = a3 ^ x18;
+    Lane x20 = a2 & x19;
+    Lane x21 = a2 & a4;
+    Lane x22 = a1 ^ a6;
+    Lane x23 = a3 ^ a5;
+    Lane x24 = x22 & x23;
+    Lane x25 = a5 ^ x24;
+    Lane x26 = a1 ^ x25;
+    Lane x27 = x21 & x26;
+    Lane x28 = x14 ^ x7;
+    Lane x29 = x20 ^ x28;
+    Lane x30 = x27 ^ x29;
+    Lane x31 = a6 | x2;
+    Lane x32 = a3 ^ x31;
+    Lane x33 = x23 & x32;
+    Lane x34 = a1 ^ x33;
+    Lane x35 = ~x34;
+    Lane x36 = ~x10;
+    Lane x37 = a6 & x36;
+    Lane x38 = a5 ^ x37;
+    Lane x39 = a4 & x38;
+    Lane x40 = ~a5;
+    Lane x41 = a3 | x40;
+    Lane x42 = a1 | x41;
+    Lane x43 = a6 & x42;
+    Lane x44 = a3 ^ x43;
+    Lane x45 = ~x44;
+    Lane x46 = a2 & x45;
+    Lane x47 = a3 ^ x24;
+    Lane x48 = a1 ^ x47;
+    Lane x49 = x21 & x48;
+    Lane x50 = x35 ^ x39;
+    Lane x51 = x46 ^ x50;
+    Lane x52 = x49 ^ x51;
+    Lane x53 = a1 & x1;
+    Lane x54 = a5 | a6;
+    Lane x55 = ~x54;
+    Lane x56 = a1 | x55;
+    Lane x57 = a3 ^ x56;
+    Lane x58 = x53 | x57;
+    Lane x59 = a5 & x15;
+    Lane x60 = a1 ^ x59;
+    Lane x61 = a6 | x60;
+    Lane x62 = a5 ^ x61;
+    Lane x63 = a4 & x62;
+    Lane x64 = ~x22;
+    Lane x65 = a3 ^ x9;
+    Lane x66 = x64 | x65;
+    Lane x67 = a2 & x66;
+    Lane x68 = x58 ^ x63;
+    Lane x69 = x67 ^ x68;
+    Lane x70 = x49 ^ x69;
+    Lane x71 = a1 | a6;
+    Lane x72 = a5 & x71;
+    Lane x73 = ~x1;
+    Lane x74 = a1 & x73;
+    Lane x75 = a3 | x74;
+    Lane x76 = x72 ^ x75;
+    Lane x77 = ~x76;
+    Lane x78 = ~a6;
+    Lane x79 = x60 | x78;
+    Lane x80 = a5 ^ x79;
+    Lane x81 = a4 & x80;
+    Lane x82 = x22 | x65;
+    Lane x83 = a2 & x82;
+    Lane x84 = x77 ^ x81;
+    Lane x85 = x83 ^ x84;
+    Lane x86 = x27 ^ x85;
+    o1 = x30;
+    o2 = x52;
+    o3 = x70;
+    o4 = x86;
+}
+
+template <typename Lane>
+inline void desSbox5(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a5 | a6;
+    Lane x2 = a5 ^ a6;
+    Lane x3 = a2 | x2;
+    Lane x4 = a4 & x3;
+    Lane x5 = x1 ^ x4;
+    Lane x6 = a2 ^ x5;
+    Lane x7 = a2 ^ a4;
+    Lane x8 = a6 & x7;
+    Lane x9 = a4 ^ x8;
+    Lane x10 = a5 | x9;
+    Lane x11 = a6 ^ x10;
+    Lane x12 = a5 ^ x11;
+    Lane x13 = a3 & x12;
+    Lane x14 = a4 | a5;
+    Lane x15 = a4 & a5;
+    Lane x16 = a2 ^ x15;
+    Lane x17 = x16 | x2;
+    Lane x18 = x14 & x17;
+    Lane x19 = a1 & x18;
+    Lane x20 = a1 & a3;
+    Lane x21 = a2 ^ a5;
+    Lane x22 = a4 ^ a6;
+    Lane x23 = x21 & x22;
+    Lane x24 = a6 ^ x23;
+    Lane x25 = ~x24;
+    Lane x26 = x20 & x25;
+    Lane x27 = x13 ^ x6;
+    Lane x28 = x19 ^ x27;
+    Lane x29 = x26 ^ x28;
+    Lane x30 = a2 | a4;
+    Lane x31 = a6 ^ x30;
+    Lane x32 = a5 ^ x31;
+    Lane x33 = a2 ^ x32;
+    Lane x34 = ~a6;
+    Lane x35 = x21 | x34;
+    Lane x36 = a4 | x35;
+    Lane x37 = a3 & x36;
+    Lane x38 = a4 | a6;
+    Lane x39 = a5 ^ x30;
+    Lane x40 = x38 & x39;
+    Lane x41 = a4 ^ x40;
+    Lane x42 = ~x41;
+    Lane x43 = a1 & x42;
+    Lane x44 = a2 & x38;
+    Lane x45 = x15 ^ x44;
+    Lane x46 = a2 ^ x45;
+    Lane x47 = x20 & x46;
+    Lane x48 = x33 ^ x37;
+    Lane x49 = x43 ^ x48;
+    Lane x50 = x47 ^ x49;
+    Lane x51 = a4 ^ a5;
+    Lane x52 = x2 & x51;
+    Lane x53 = a2 | x52;
+    Lane x54 = a4 ^ x53;
+    Lane x55 = ~x54;
+    Lane x56 = x51 & x7;
+    Lane x57 = a6 | x56;
+    Lane x58 = a5 ^ x57;
+    Lane x59 = a3 & x58;
+    Lane x60 = a2 & a4;
+    Lane x61 = a2 ^ x22;
+    Lane x62 = ~x61;
+    Lane x63 = x21 | x62;
+    Lane x64 = x60 | x63;
+    Lane x65 = a1 & x64;
+    Lane x66 = x21 | x9;
+    Lane x67 = a6 ^ x66;
+    Lane x68 = ~x67;
+    Lane x69 = x20 & x68;
+    Lane x70 = x55 ^ x59;
+    Lane x71 = x65 ^ x70;
+    Lane x72 = x69 ^ x71;
+    Lane x73 = a2 & x2;
+    Lane x74 = x23 | x73;
+    Lane x75 = a2 & a5;
+    Lane x76 = ~x1;
+    Lane x77 = a4 | x76;
+    Lane x78 = x75 ^ x77;
+    Lane x79 = a3 & x78;
+    Lane x80 = a2 | x22;
+    Lane x81 = a6 ^ x80;
+    Lane x82 = a5 | x81;
+    Lane x83 = a6 ^ x82;
+    Lane x84 = a5 ^ x83;
+    Lane x85 = a1 & x84;
+    Lane x86 = a2 ^ x1;
+    Lane x87 = x7 & x86;
+    Lane x88 = a6 ^ x87;
+    Lane x89 = ~x88;
+    Lane x90 = x20 & x89;
+    Lane x91 = x74 ^ x79;
+    Lane x92 = x85 ^ x91;
+    Lane x93 = x90 ^ x92;
+    o1 = x29;
+    o2 = x50;
+    o3 = x72;
+    o4 = x93;
+}
+
+template <typename Lane>
+inline void desSbox6(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a1 ^ a4;
+    Lane x2 = a3 | a5;
+    Lane x3 = x1 & x2;
+    Lane x4 = a5 ^ x3;
+    Lane x5 = ~x4;
+    Lane x6 = a1 ^ a3;
+    Lane x7 = x1 | x6;
+    Lane x8 = a5 | x7;
+    Lane x9 = a6 & x8;
+    Lane x10 = ~a3;
+    Lane x11 = a2 & x10;
+    Lane x12 = a2 & a6;
+    Lane x13 = a3 | a4;
+    Lane x14 = a1 & a5;
+    Lane x15 = a3 & a4;
+    Lane x16 = x14 | x15;
+    Lane x17 = a1 ^ x16;
+    Lane x18 = x13 & x17;
+    Lane x19 = x12 & x18;
+    Lane x20 = x5 ^ x9;
+    Lane x21 = x11 ^ x20;
+    Lane x22 = x19 ^ x21;
+    Lane x23 = a4 & a5;
+    Lane x24 = a3 ^ x23;
+    Lane x25 = a1 | a3;
+    Lane x26 = a5 ^ x25;
+    Lane x27 = x24 | x26;
+    Lane x28 = a4 ^ x27;
+    Lane x29 = ~x28;
+    Lane x30 = a3 ^ a4;
+    Lane x31 = a5 & x30;
+    Lane x32 = a3 ^ x31;
+    Lane x33 = a1 & x32;
+    Lane x34 = ~x33;
+    Lane x35 = a6 & x34;
+    Lane x36 = a1 & a3;
+    Lane x37 = a4 ^ x36;
+    Lane x38 = ~x37;
+    Lane x39 = x14 | x38;
+    Lane x40 = a2 & x39;
+    Lane x41 = a4 | a5;
+    Lane x42 = a4 ^ a5;
+    Lane x43 = x36 | x42;
+    Lane x44 = x41 ^ x43;
+    Lane x45 = x12 & x44;
+    Lane x46 = x29 ^ x35;
+    Lane x47 = x40 ^ x46;
+    Lane x48 = x45 ^ x47;
+    Lane x49 = a5 & x25;
+    Lane x50 = x36 ^ x49;
+    Lane x51 = a4 ^ x50;
+    Lane x52 = a1 | a4;
+    Lane x53 = a1 & x10;
+    Lane x54 = a5 | x53;
+    Lane x55 = x52 & x54;
+    Lane x56 = ~x55;
+    Lane x57 = a6 & x56;
+    Lane x58 = a3 & a5;
+    Lane x59 = a1 | x24;
+    Lane x60 = x58 ^ x59;
+    Lane x61 = a2 & x60;
+    Lane x62 = a1 & x30;
+    Lane x63 = ~x62;
+    Lane x64 = a5 & x63;
+    Lane x65 = x12 & x64;
+    Lane x66 = x51 ^ x57;
+    Lane x67 = x61 ^ x66;
+    Lane x68 = x65 ^ x67;
+    Lane x69 = a1 ^ a5;
+    Lane x70 = a4 & x25;
+    Lane x71 = x36 ^ x70;
+    Lane x72 = x69 | x71;
+    Lane x73 = a3 ^ x72;
+    Lane x74 = a4 & x2;
+    Lane x75 = a1 | x74;
+    Lane x76 = a6 & x75;
+    Lane x77 = a2 & x13;
+    Lane x78 = a1 | a5;
+    Lane x79 = a3 ^ x78;
+    Lane x80 = x1 & x79;
+    Lane x81 = x12 & x80;
+    Lane x82 = x73 ^ x76;
+    Lane x83 = x77 ^ x82;
+    Lane x84 = x81 ^ x83;
+    o1 = x22;
+    o2 = x48;
+    o3 = x68;
+    o4 = x84;
+}
+
+template <typename Lane>
+inline void desSbox7(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a2 | a6;
+    Lane x2 = a1 ^ a6;
+    Lane x3 = a1 & a2;
+    Lane x4 = a3 ^ x3;
+    Lane x5 = x2 | x4;
+    Lane x6 = x1 & x5;
+    Lane x7 = a3 ^ x6;
+    Lane x8 = ~a3;
+    Lane x9 = a2 | x8;
+    Lane x10 = a6 ^ x9;
+    Lane x11 = a1 & x10;
+    Lane x12 = ~x11;
+    Lane x13 = a5 & x12;
+    Lane x14 = a6 | x8;
+    Lane x15 = a2 & x14;
+    Lane x16 = a1 | x15;
+    Lane x17 = a4 & x16;
+    Lane x18 = a4 & a5;
+    Lane x19 = a1 | a3;
+    Lane x20 = ~a1;
+    Lane x21 = a2 | x20;
+    Lane x22 = a6 ^ x21;
+    Lane x23 = x19 & x22;
+    Lane x24 = x18 & x23;
+    Lane x25 = x13 ^ x7;
+    Lane x26 = x17 ^ x25;
+    Lane x27 = x24 ^ x26;
+    Lane x28 = a3 ^ a6;
+    Lane x29 = a2 ^ x28;
+    Lane x30 = a1 ^ a2;
+    Lane x31 = a1 & a3;
+    Lane x32 = x30 | x31;
+    Lane x33 = x29 & x32;
+    Lane x34 = a1 ^ x33;
+    Lane x35 = ~x34;
+    Lane x36 = a1 & x28;
+    Lane x37 = x30 | x36;
+    Lane x38 = ~x37;
+    Lane x39 = a4 & x38;
+    Lane x40 = a2 & a6;
+    Lane x41 = a3 ^ x40;
+    Lane x42 = x2 & x41;
+    Lane x43 = x18 & x42;
+    Lane x44 = a5 ^ x35;
+    Lane x45 = x39 ^ x44;
+    Lane x46 = x43 ^ x45;
+    Lane x47 = a1 ^ a3;
+    Lane x48 = x3 | x47;
+    Lane x49 = x28 & x48;
+    Lane x50 = a2 ^ x49;
+    Lane x51 = a1 & x9;
+    Lane x52 = a6 | x51;
+    Lane x53 = ~x52;
+    Lane x54 = a5 & x53;
+    Lane x55 = a3 & a6;
+    Lane x56 = a1 | x55;
+    Lane x57 = ~x56;
+    Lane x58 = a2 | x57;
+    Lane x59 = a1 ^ x58;
+    Lane x60 = a4 & x59;
+    Lane x61 = a2 | x2;
+    Lane x62 = x56 ^ x61;
+    Lane x63 = ~x62;
+    Lane x64 = x18 & x63;
+    Lane x65 = x50 ^ x54;
+    Lane x66 = x60 ^ x65;
+    Lane x67 = x64 ^ x66;
+    Lane x68 = a2 & a3;
+    Lane x69 = a1 & x68;
+    Lane x70 = a2 | a3;
+    Lane x71 = a6 ^ x70;
+    Lane x72 = x69 | x71;
+    Lane x73 = a1 ^ x72;
+    Lane x74 = a1 & x40;
+    Lane x75 = ~x74;
+    Lane x76 = a5 & x75;
+    Lane x77 = a1 & a6;
+    Lane x78 = x41 | x77;
+    Lane x79 = a4 & x78;
+    Lane x80 = a3 | x77;
+    Lane x81 = x40 ^ x80;
+    Lane x82 = ~x81;
+    Lane x83 = x18 & x82;
+    Lane x84 = x73 ^ x76;
+    Lane x85 = x79 ^ x84;
+    Lane x86 = x83 ^ x85;
+    o1 = x27;
+    o2 = x46;
+    o3 = x67;
+    o4 = x86;
+}
+
+template <typename Lane>
+inline void desSbox8(Lane a1, Lane a2, Lane a3, Lane a4, Lane a5, Lane a6,
+    Lane& o1, Lane& o2, Lane& o3, Lane& o4) {
+    Lane x1 = a4 & a6;
+    Lane x2 = a3 & a4;
+    Lane x3 = a5 ^ x2;
+    Lane x4 = x1 | x3;
+    Lane x5 = a6 ^ x4;
+    Lane x6 = a3 ^ x5;
+    Lane x7 = ~x6;
+    Lane x8 = a3 | a6;
+    Lane x9 = a4 & x8;
+    Lane x10 = a4 ^ a6;
+    Lane x11 = a5 | x10;
+    Lane x12 = x11 ^ x9;
+    Lane x13 = a2 & x12;
+    Lane x14 = a3 ^ a5;
+    Lane x15 = a4 | a6;
+    Lane x16 = a3 ^ x15;
+    Lane x17 = x14 & x16;
+    Lane x18 = a6 ^ x17;
+    Lane x19 = a3 ^ x18;
+    Lane x20 = ~x19;
+    Lane x21 = a1 & x20;
+    Lane x22 = a1 & a2;
+    Lane x23 = a3 | a4;
+    Lane x24 = a5 & a6;
+    Lane x25 = x2 | x24;
+    Lane x26 = a6 ^ x25;
+    Lane x27 = x23 & x26;
+    Lane x28 = x22 & x27;
+    Lane x29 = x13 ^ x7;
+    Lane x30 = x21 ^ x29;
+    Lane x31 = x28 ^ x30;
+    Lane x32 = ~a5;
+    Lane x33 = a3 | x32;
+    Lane x34 = a6 ^ x33;
+    Lane x35 = a4 ^ x34;
+    Lane x36 = a4 | a5;
+    Lane x37 = a3 ^ x36;
+    Lane x38 = ~x37;
+    Lane x39 = a2 & x38;
+    Lane x40 = a4 ^ a5;
+    Lane x41 = x40 & x8;
+    Lane x42 = a4 ^ x41;
+    Lane x43 = a3 ^ x42;
+    Lane x44 = a1 & x43;
+    Lane x45 = ~a4;
+    Lane x46 = a6 | x45;
+    Lane x47 = a3 & x46;
+    Lane x48 = x36 ^ x47;
+    Lane x49 = x22 & x48;
+    Lane x50 = x35 ^ x39;
+    Lane x51 = x44 ^ x50;
+    Lane x52 = x49 ^ x51;
+    Lane x53 = a3 ^ a4;
+    Lane x54 = a5 | x53;
+    Lane x55 = a4 ^ x54;
+    Lane x56 = ~a6;
+    Lane x57 = x14 | x56;
+    Lane x58 = a4 | x57;
+    Lane x59 = a2 & x58;
+    Lane x60 = a3 & a5;
+    Lane x61 = ~x36;
+    Lane x62 = a6 | x61;
+    Lane x63 = x60 ^ x62;
+    Lane x64 = a1 & x63;
+    Lane x65 = a6 & x53;
+    Lane x66 = a3 ^ x65;
+    Lane x67 = ~x66;
+    Lane x68 = a5 & x67;
+    Lane x69 = x22 & x68;
+    Lane x70 = x55 ^ x59;
+    Lane x71 = x64 ^ x70;
+    Lane x72 = x69 ^ x71;
+    Lane x73 = a3 ^ x40;
+    Lane x74 = a6 & x73;
+    Lane x75 = x61 | x74;
+    Lane x76 = a3 ^ x75;
+    Lane x77 = a3 & a6;
+    Lane x78 = a5 & x10;
+    Lane x79 = x77 ^ x78;
+    Lane x80 = ~x79;
+    Lane x81 = a2 & x80;
+    Lane x82 = a5 ^ a6;
+    Lane x83 = a3 ^ x82;
+    Lane x84 = x1 | x83;
+    Lane x85 = x60 | x84;
+    Lane x86 = a1 & x85;
+    Lane x87 = a4 ^ x8;
+    Lane x88 = x73 & x87;
+    Lane x89 = x22 & x88;
+    Lane x90 = x76 ^ x81;
+    Lane x91 = x86 ^ x90;
+    Lane x92 = x89 ^ x91;
+    o1 = x31;
+    o2 = x52;
+    o3 = x72;
+    o4 = x92;
+}
+
+// λƬʹõԿλk[r][j]ΪrԿjλ(Ӹλ𣬴0ʼ)ȡԭʼԿĵڼλ(0ʼ)
+// PC-1ѭƺPC-2һλƬʱҪԿ
+struct BitsliceKeyBits {
+    uint8_t k[16][48];
+};
+
+constexpr BitsliceKeyBits makeBitsliceKeyBits() {
+    BitsliceKeyBits table = {};
+    int shift = 0;
+    for (int r = 0; r < 16; r++) {
+        shift += SHIFT[r];
+        for (int j = 0; j < 48; j++) {
+            // ԿjλȡѭƺCDĵPC2[j]λCD28λѭ
+            int m = PC2[j] - 1;
+            int src = m < 28 ? (m + shift) % 28 : 28 + (m - 28 + shift) % 28;
+            table.k[r][j] = static_cast<uint8_t>(PC1[src] - 1);
+        }
+    }
+    return table;
+}
+
+constexpr BitsliceKeyBits BS_KEY_BITS = makeBitsliceKeyBits();
+
+// PûSиλλãp[i]ΪSĵiλ(0ʼ)Fеλ(0ʼ)
+struct BitslicePPos {
+    uint8_t p[32];
+};
+
+constexpr BitslicePPos makeBitslicePPos() {
+    BitslicePPos table = {};
+    for (int i = 0; i < 32; i++) {
+        table.p[P[i] - 1] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+
+constexpr BitslicePPos BS_P_POS = makeBitslicePPos();
+
+// iSУRλƽȡչû6λԿλŵ·PûL
+template <typename Lane, typename Sbox>
+inline void bitsliceSbox(int i, Sbox sbox, Lane* l, const Lane* r, const Lane* key, const uint8_t* kb) {
+    const int* e = E + i * 6;
+    kb += i * 6;
+    Lane o1, o2, o3, o4;
+    sbox(r[e[0] - 1] ^ key[kb[0]], r[e[1] - 1] ^ key[kb[1]], r[e[2] - 1] ^ key[kb[2]],
+        r[e[3] - 1] ^ key[kb[3]], r[e[4] - 1] ^ key[kb[4]], r[e[5] - 1] ^ key[kb[5]], o1, o2, o3, o4);
+    l[BS_P_POS.p[i * 4]] ^= o1;
+    l[BS_P_POS.p[i * 4 + 1]] ^= o2;
+    l[BS_P_POS.p[i * 4 + 2]] ^= o3;
+    l[BS_P_POS.p[i * 4 + 3]] ^= o4;
+}
+
+// λƬDESplanes[k]Ϊk+1λ(Ӹλ)ɵλƽ棬ԭؼܻܣ
+// key[k]ΪԿk+1λλƽ
+template <typename Lane>
+void desBitslice(Lane* planes, const Lane* key, OperationMode mode) {
+    // ʼûֻ±
+    Lane L[32], R[32];
+    for (int i = 0; i < 32; i++) {
+        L[i] = planes[IP[i] - 1];
+        R[i] = planes[IP[i + 32] - 1];
+    }
+
+    // ÿL ^= F(R, K)󽻻Ľɫƶ
+    Lane* l = L;
+    Lane* r = R;
+    for (int round = 0; round < 16; round++) {
+        const uint8_t* kb = BS_KEY_BITS.k[mode == ENCRYPT ? round : 15 - round];
+        bitsliceSbox(0, desSbox1<Lane>, l, r, key, kb);
+        bitsliceSbox(1, desSbox2<Lane>, l, r, key, kb);
+        bitsliceSbox(2, desSbox3<Lane>, l, r, key, kb);
+        bitsliceSbox(3, desSbox4<Lane>, l, r, key, kb);
+        bitsliceSbox(4, desSbox5<Lane>, l, r, key, kb);
+        bitsliceSbox(5, desSbox6<Lane>, l, r, key, kb);
+        bitsliceSbox(6, desSbox7<Lane>, l, r, key, kb);
+        bitsliceSbox(7, desSbox8<Lane>, l, r, key, kb);
+        Lane* temp = l;
+        l = r;
+        r = temp;
+    }
+
+    // 16ֺlrΪL16R16R16L16ʼûû
+    for (int i = 0; i < 64; i++) {
+        int k = IP_INV[i] - 1;
+        planes[i] = k < 32 ? r[k] : l[k - 32];
+    }
+}
+
+// 6464λתãa[j]Ϊjʱתúa[i]Ϊi+1λ(Ӹλ)ɵλƽ棬
+// jеĵ63-jλת棬ͬһҲλƽתظ
+void transpose64(uint64_t* a) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = (a[k] ^ (a[k | j] >> j)) & mask;
+            a[k] ^= t;
+            a[k | j] ^= t << j;
+        }
+    }
+}
+
+// 64λͨһ64
+inline void laneSet(uint64_t& lane, bool bit) {
+    lane = bit ? ~0ULL : 0;
+}
+
+inline void bitsliceLoad(const uint8_t* in, uint64_t* planes) {
+    for (int j = 0; j < 64; j++) {
+        planes[j] = loadBE64(in + j * 8);
+    }
+    transpose64(planes);
+}
+
+inline void bitsliceStore(uint64_t* planes, uint8_t* out) {
+    transpose64(planes);
+    for (int j = 0; j < 64; j++) {
+        storeBE64(out + j * 8, planes[j]);
+    }
+}
+
+#if DES_HAVE_SSE2
+// 128λͨSSE2Ĵһ128飬64λΪǰ64
+struct Lane128 {
+    __m128i v;
+};
+
+inline Lane128 operator&(Lane128 a, Lane128 b) { return Lane128{ _mm_and_si128(a.v, b.v) }; }
+inline Lane128 operator|(Lane128 a, Lane128 b) { return Lane128{ _mm_or_si128(a.v, b.v) }; }
+inline Lane128 operator^(Lane128 a, Lane128 b) { return Lane128{ _mm_xor_si128(a.v, b.v) }; }
+inline Lane128 operator~(Lane128 a) { return Lane128{ _mm_xor_si128(a.v, _mm_set1_epi32(-1)) }; }
+inline Lane128& operator^=(Lane128& a, Lane128 b) { a.v = _mm_xor_si128(a.v, b.v); return a; }
+
+inline void laneSet(Lane128& lane, bool bit) {
+    lane.v = _mm_set1_epi32(bit ? -1 : 0);
+}
+
+inline void bitsliceLoad(const uint8_t* in, Lane128* planes) {
+    uint64_t lo[64], hi[64];
+    bitsliceLoad(in, lo);
+    bitsliceLoad(in + 64 * 8, hi);
+    for (int i = 0; i < 64; i++) {
+        planes[i].v = _mm_set_epi64x(static_cast<long long>(hi[i]), static_cast<long long>(lo[i]));
+    }
+}
+
+inline void bitsliceStore(Lane128* planes, uint8_t* out) {
+    uint64_t lo[64], hi[64];
+    for (int i = 0; i < 64; i++) {
+        uint64_t pair[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pair), planes[i].v);
+        lo[i] = pair[0];
+        hi[i] = pair[1];
+    }
+    bitsliceStore(lo, out);
+    bitsliceStore(hi, out + 64 * 8);
+}
+
+typedef Lane128 BitsliceLane;
+#else
+typedef uint64_t BitsliceLane;
+#endif
+
+// ӽʹõλƬ()
+const size_t BITSLICE_BLOCKS = sizeof(BitsliceLane) * 8;
+
+// ֽڴʮַת
+string toHex(const string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    for (char ch : bytes) {
+        uint8_t c = static_cast<uint8_t>(ch);
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0F];
+    }
+    return hex;
+}
+
+string fromHex(const string& hex) {
+    if (hex.length() % 2 != 0) {
+        throw invalid_argument("ʮַȱż");
+    }
+    string bytes;
+    for (size_t i = 0; i < hex.length(); i += 2) {
+        size_t used = 0;
+        int value = stoi(hex.substr(i, 2), &used, 16);
+        if (used != 2) {
+            throw invalid_argument("Чʮַ: " + hex);
+        }
+        bytes += static_cast<char>(value);
+    }
+    return bytes;
+}
+
+// 16ʮַΪ64λ
+uint64_t parseHexBlock(const string& hex, const string& what) {
+    if (hex.length() != 16 || hex.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+        throw invalid_argument(what + "16ʮַ");
+    }
+    return stoull(hex, nullptr, 16);
+}
+
+// 룺DES3DES(EDE)ʱһøԿţֻ֮
+struct DesCipher {
+    DesCipher(const string& key, DESVariant variant, DESBackend backend = DES_BACKEND_AUTO)
+        : variant(variant), backend(backend == DES_BACKEND_AUTO ? DES_BACKEND_BITSLICE : backend) {
+        size_t count = variant == DES_SINGLE ? 1 : (variant == TDES_EDE2 ? 2 : 3);
+        if (key.length() != count * 8) {
+            throw invalid_argument("Կ" + to_string(count * 8) + "ַ");
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint64_t k = stringToKey(key.substr(i * 8, 8));
+            schedules[i] = makeKeySchedule(k);
+            for (int b = 0; b < 64; b++) {
+                laneSet(bitsliceKeys[i][b], (k >> (63 - b)) & 1);
+            }
+        }
+        // ˫Կ3DESĵʹK1
+        if (variant == TDES_EDE2) {
+            schedules[2] = schedules[0];
+            memcpy(bitsliceKeys[2], bitsliceKeys[0], sizeof(bitsliceKeys[0]));
+        }
+    }
+
+    // ܣE(K3, D(K2, E(K1, x)))֮䲻IP^-1/IP
+    uint64_t encryptBlock(uint64_t block) const {
+        return cryptBlock(block, ENCRYPT);
+    }
+
+    // ܣD(K1, E(K2, D(K3, x)))
+    uint64_t decryptBlock(uint64_t block) const {
+        return cryptBlock(block, DECRYPT);
+    }
+
+    // /n໥8ֽڿ(ECB)inoutͬ
+    // λƬ˰BITSLICE_BLOCKSһ˺ʣĿÿν4
+    void encryptBlocks(const uint8_t* in, uint8_t* out, size_t n) const {
+        cryptBlocks(in, out, n, ENCRYPT);
+    }
+
+    void decryptBlocks(const uint8_t* in, uint8_t* out, size_t n) const {
+        cryptBlocks(in, out, n, DECRYPT);
+    }
+
+    DESVariant variant;
+    DESBackend backend;           // ʵʹõĺ(DES_BACKEND_AUTO)
+    DesKeySchedule schedules[3];  // ԿţDESֻõһ
+    BitsliceLane bitsliceKeys[3][64];  // Կλƽ(ÿλȫ0ȫ1)
+
+private:
+    // ȡʹõ򣬷ؼ
+    int stageKeys(OperationMode mode, const uint8_t (*stages[3])[8]) const {
+        if (variant == DES_SINGLE) {
+            stages[0] = mode == ENCRYPT ? schedules[0].enc : schedules[0].dec;
+            return 1;
+        }
+        if (mode == ENCRYPT) {
+            stages[0] = schedules[0].enc;
+            stages[1] = schedules[1].dec;
+            stages[2] = schedules[2].enc;
+        }
+        else {
+            stages[0] = schedules[2].dec;
+            stages[1] = schedules[1].enc;
+            stages[2] = schedules[0].dec;
+        }
+        return 3;
+    }
+
+    uint64_t cryptBlock(uint64_t block, OperationMode mode) const {
+        const uint8_t (*stages[3])[8];
+        int count = stageKeys(mode, stages);
+
+        uint64_t permuted = permuteBytes(block, IP_TABLE);
+        uint32_t L = (permuted >> 32) & 0xFFFFFFFF;
+        uint32_t R = permuted & 0xFFFFFFFF;
+        for (int s = 0; s < count; s++) {
+            desRounds(L, R, stages[s]);
+        }
+        return permuteBytes(((uint64_t)L << 32) | R, FP_TABLE);
+    }
+
+    void cryptBlocks(const uint8_t* in, uint8_t* out, size_t n, OperationMode mode) const {
+        size_t i = 0;
+        if (backend == DES_BACKEND_BITSLICE) {
+            BitsliceLane planes[64];
+            for (; i + BITSLICE_BLOCKS <= n; i += BITSLICE_BLOCKS) {
+                bitsliceLoad(in + i * 8, planes);
+                if (variant == DES_SINGLE) {
+                    desBitslice(planes, bitsliceKeys[0], mode);
+                }
+                else if (mode == ENCRYPT) {
+                    desBitslice(planes, bitsliceKeys[0], ENCRYPT);
+                    desBitslice(planes, bitsliceKeys[1], DECRYPT);
+                    desBitslice(planes, bitsliceKeys[2], ENCRYPT);
+                }
+                else {
+                    desBitslice(planes, bitsliceKeys[2], DECRYPT);
+                    desBitslice(planes, bitsliceKeys[1], ENCRYPT);
+                    desBitslice(planes, bitsliceKeys[0], DECRYPT);
+                }
+                bitsliceStore(planes, out + i * 8);
+            }
+        }
+
+        const uint8_t (*stages[3])[8];
+        int count = stageKeys(mode, stages);
+        for (; i + 4 <= n; i += 4) {
+            uint32_t L[4], R[4];
+            for (int j = 0; j < 4; j++) {
+                uint64_t permuted = permuteBytes(loadBE64(in + (i + j) * 8), IP_TABLE);
+                L[j] = (permuted >> 32) & 0xFFFFFFFF;
+                R[j] = permuted & 0xFFFFFFFF;
+            }
+            for (int s = 0; s < count; s++) {
+                desRoundsN<4>(L, R, stages[s]);
+            }
+            for (int j = 0; j < 4; j++) {
+                storeBE64(out + (i + j) * 8, permuteBytes(((uint64_t)L[j] << 32) | R[j], FP_TABLE));
+            }
+        }
+        for (; i < n; i++) {
+            storeBE64(out + i * 8, cryptBlock(loadBE64(in + i * 8), mode));
+        }
+    }
+};
+
 // в
 Args parseArgs(int argc, char* argv[]) {
     Args args;
     args.opMode = ENCRYPT; // Ĭϼ
     args.desMode = ECB;    // ĬECBģʽ
+    args.variant = DES_SINGLE;
+    args.backend = DES_BACKEND_AUTO;
+    args.segment = 8;      // Ĭ8λֶΣļ
+    args.threads = 0;      // δָӽΪ1ԿΪCPU
+    args.search = false;
+    args.charset = "abcdefghijklmnopqrstuvwxyz0123456789";
 
     for (int i = 1; i < argc; ++i) {
         string arg = argv[i];
@@ -319,6 +1601,7 @@ Args parseArgs(int argc, char* argv[]) {
             string mode = argv[++i];
             if (mode == "encrypt") args.opMode = ENCRYPT;
             else if (mode == "decrypt") args.opMode = DECRYPT;
+            else if (mode == "search") args.search = true;
             else throw invalid_argument("Чģʽ: " + mode);
         }
         else if (arg == "-d" || arg == "--des-mode") {
@@ -333,8 +1616,38 @@ Args parseArgs(int argc, char* argv[]) {
         else if (arg == "-k" || arg == "--key") {
             if (i + 1 >= argc) throw invalid_argument("ȱԿֵ");
             args.key = argv[++i];
-            if (args.key.length() != 8) {
-                throw invalid_argument("Կ8ַ");
+        }
+        else if (arg == "--des-variant") {
+            if (i + 1 >= argc) throw invalid_argument("ȱDESֵ");
+            string variant = argv[++i];
+            if (variant == "des") args.variant = DES_SINGLE;
+            else if (variant == "3des2") args.variant = TDES_EDE2;
+            else if (variant == "3des3") args.variant = TDES_EDE3;
+            else throw invalid_argument("ЧDES: " + variant);
+        }
+        else if (arg == "-b" || arg == "--backend") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٺ˲ֵ");
+            string backend = argv[++i];
+            if (backend == "auto") args.backend = DES_BACKEND_AUTO;
+            else if (backend == "table") args.backend = DES_BACKEND_TABLE;
+            else if (backend == "bitslice") args.backend = DES_BACKEND_BITSLICE;
+            else throw invalid_argument("Чĺ: " + backend);
+        }
+        else if (arg == "-s" || arg == "--segment") {
+            if (i + 1 >= argc) throw invalid_argument("ȱٷֶγȲֵ");
+            string segment = argv[++i];
+            if (segment == "8") args.segment = 8;
+            else if (segment == "64") args.segment = 64;
+            else throw invalid_argument("Чķֶγ: " + segment);
+        }
+        else if (arg == "-t" || arg == "--threads") {
+            if (i + 1 >= argc) throw invalid_argument("ȱֵ߳");
+            args.threads = stoi(argv[++i]);
+            if (args.threads < 0) {
+                throw invalid_argument("߳Ϊ");
+            }
+            if (args.threads == 0) {
+                args.threads = max(1, static_cast<int>(thread::hardware_concurrency()));
             }
         }
         else if (arg == "-i" || arg == "--iv") {
@@ -344,6 +1657,26 @@ Args parseArgs(int argc, char* argv[]) {
                 throw invalid_argument("ʼ8ַ");
             }
         }
+        else if (arg == "--known-plain") {
+            if (i + 1 >= argc) throw invalid_argument("ȱ֪Ĳֵ");
+            args.knownPlain = argv[++i];
+        }
+        else if (arg == "--known-cipher") {
+            if (i + 1 >= argc) throw invalid_argument("ȱ֪Ĳֵ");
+            args.knownCipher = argv[++i];
+        }
+        else if (arg == "--charset") {
+            if (i + 1 >= argc) throw invalid_argument("ȱֵַ");
+            args.charset = argv[++i];
+        }
+        else if (arg == "--prefix") {
+            if (i + 1 >= argc) throw invalid_argument("ȱԿǰ׺ֵ");
+            args.prefix = argv[++i];
+        }
+        else if (arg == "--checkpoint") {
+            if (i + 1 >= argc) throw invalid_argument("ȱټļֵ");
+            args.checkpointFile = argv[++i];
+        }
         else if (arg == "-f" || arg == "--file") {
             if (i + 1 >= argc) throw invalid_argument("ȱļֵ");
             args.inputFile = argv[++i];
@@ -356,13 +1689,25 @@ Args parseArgs(int argc, char* argv[]) {
             cout << "DESӽܹ" << endl;
             cout << "÷: " << argv[0] << " [ѡ]" << endl;
             cout << "ѡ:" << endl;
-            cout << "  -m, --mode     ģʽ: encrypt()  decrypt()Ĭencrypt" << endl;
+            cout << "  -m, --mode     ģʽ: encrypt(), decrypt()  search(֪Կ)Ĭencrypt" << endl;
             cout << "  -d, --des-mode DESģʽ: ecb, cbc, cfb, ofbĬecb" << endl;
-            cout << "  -k, --key      Կ8ַ" << endl;
+            cout << "  -k, --key      ԿDESΪ8ַ3des2Ϊ16ַ3des3Ϊ24ַ" << endl;
+            cout << "  --des-variant  : des, 3des2(˫Կ3DES), 3des3(Կ3DES)Ĭdes" << endl;
+            cout << "  -b, --backend  ӽ(ECBCBCܡCFB-64)ĺ: auto, table(), bitslice(λƬʱ)Ĭauto" << endl;
             cout << "  -i, --iv       ʼ8ַ(CBC/CFB/OFBģʽҪ)" << endl;
+            cout << "  -s, --segment  CFB/OFBֶγ: 8(ֽڣݾļ), 64()Ĭ8" << endl;
+            cout << "  -t, --threads  ECBCBCܺCFB-64ʹõ߳0ʾCPUĬ1" << endl;
+            cout << "                 2ʱOFBɵ߳ԤԿ" << endl;
             cout << "  -f, --file     ļ·" << endl;
             cout << "  -o, --output   ļ·" << endl;
             cout << "  -h, --help     ʾϢ" << endl;
+            cout << "Կ(-m searchDES8ַԿ):" << endl;
+            cout << "  --known-plain  ֪Ŀ飬16ʮַ" << endl;
+            cout << "  --known-cipher ӦĿ飬16ʮַ" << endl;
+            cout << "  --prefix       ֪Կǰ׺ַַö" << endl;
+            cout << "  --charset      δַַ֪ĬСдĸ" << endl;
+            cout << "  --checkpoint   ļڱȣļѴʱжϴ" << endl;
+            cout << "  -t, --threads  ʹõ߳ĬCPU" << endl;
             exit(0);
         }
         else {
@@ -370,6 +1715,32 @@ Args parseArgs(int argc, char* argv[]) {
         }
     }
 
+    if (args.threads == 0) {
+        args.threads = args.search ? max(1, static_cast<int>(thread::hardware_concurrency())) : 1;
+    }
+
+    // Կдļ
+    if (args.search) {
+        if (args.variant != DES_SINGLE) {
+            throw invalid_argument("Կֵֻ֧DES");
+        }
+        if (args.knownPlain.empty() || args.knownCipher.empty()) {
+            throw invalid_argument("ԿҪ--known-plain--known-cipher");
+        }
+        parseHexBlock(args.knownPlain, "֪");
+        parseHexBlock(args.knownCipher, "֪");
+        if (args.prefix.length() > 8) {
+            throw invalid_argument("Կǰ׺ܳ8ַ");
+        }
+        if (args.prefix.length() < 8 && args.charset.empty()) {
+            throw invalid_argument("ַΪ");
+        }
+        return args;
+    }
+    if (!args.checkpointFile.empty()) {
+        throw invalid_argument("--checkpointֻԿ");
+    }
+
     // ֤Ҫ
     if (args.inputFile.empty()) {
         throw invalid_argument("ṩļ");
@@ -380,6 +1751,10 @@ Args parseArgs(int argc, char* argv[]) {
     if (args.key.empty()) {
         throw invalid_argument("ṩԿ");
     }
+    size_t keySize = args.variant == DES_SINGLE ? 8 : (args.variant == TDES_EDE2 ? 16 : 24);
+    if (args.key.length() != keySize) {
+        throw invalid_argument("Կ" + to_string(keySize) + "ַ");
+    }
 
     // ֤IV
     if ((args.desMode == CBC || args.desMode == CFB || args.desMode == OFB) && args.iv.empty()) {
@@ -418,23 +1793,20 @@ void writeFile(const string& filename, const vector<uint8_t>& data) {
     file.write(reinterpret_cast<const char*>(data.data()), data.size());
 }
 
-// 䣨PKCS#7
-vector<uint8_t> addPadding(const vector<uint8_t>& data) {
-    size_t blockSize = 8;
-    size_t paddingSize = blockSize - (data.size() % blockSize);
-    vector<uint8_t> padded = data;
-
-    for (size_t i = 0; i < paddingSize; i++) {
-        padded.push_back(static_cast<uint8_t>(paddingSize));
-    }
-
-    return padded;
+// PKCS#7䣺ֻһݣΪ0ֽڣƵblock룬
+// ǰֱӴԭݴ롣鲿ֵֽ
+size_t padFinalBlock(const vector<uint8_t>& data, uint8_t* block) {
+    size_t full = data.size() / 8 * 8;
+    size_t rest = data.size() - full;
+    memcpy(block, data.data() + full, rest);
+    memset(block + rest, static_cast<int>(8 - rest), 8 - rest);
+    return full;
 }
 
-// Ƴ
-vector<uint8_t> removePadding(const vector<uint8_t>& data) {
+// Ƴ䣺һֽںֱӽض̣
+void trimPadding(vector<uint8_t>& data) {
     if (data.empty()) {
-        return data;
+        return;
     }
 
     size_t paddingSize = data.back();
@@ -442,195 +1814,676 @@ vector<uint8_t> removePadding(const vector<uint8_t>& data) {
         throw runtime_error("Ч");
     }
 
-    return vector<uint8_t>(data.begin(), data.end() - paddingSize);
+    data.resize(data.size() - paddingSize);
 }
 
-// ECBģʽ
-vector<uint8_t> ecbEncrypt(const vector<uint8_t>& data, const vector<uint64_t>& subkeys) {
-    vector<uint8_t> padded = addPadding(data);
-    vector<uint8_t> result;
-    result.reserve(padded.size());
-
-    // 鴦
-    for (size_t i = 0; i < padded.size(); i += 8) {
-        uint64_t block = 0;
-        for (int j = 0; j < 8; j++) {
-            block = (block << 8) | padded[i + j];
-        }
+// ̴߳ʱÿ8ıɷ棩
+const size_t CHUNK_SIZE = 256 * 1024;
 
-        uint64_t encrypted = desBlockEncrypt(block, subkeys);
+// [0, len)CHUNK_SIZEз֣threads̲߳д߳ͨԭӼȡһ
+void forEachChunk(size_t len, int threads, const function<void(size_t, size_t)>& task) {
+    size_t chunks = (len + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    atomic<size_t> next(0);
 
-        // ܺĿӵ
-        for (int j = 7; j >= 0; j--) {
-            result.push_back(static_cast<uint8_t>((encrypted >> (j * 8)) & 0xFF));
+    auto worker = [&]() {
+        for (size_t c = next++; c < chunks; c = next++) {
+            size_t offset = c * CHUNK_SIZE;
+            task(offset, min(CHUNK_SIZE, len - offset));
         }
+    };
+
+    size_t workers = min(static_cast<size_t>(max(threads, 1)), chunks);
+    vector<thread> pool;
+    for (size_t t = 1; t < workers; t++) {
+        pool.emplace_back(worker);
     }
+    worker();
+    for (thread& t : pool) {
+        t.join();
+    }
+}
+
+// ECBģʽ
+vector<uint8_t> ecbEncrypt(const vector<uint8_t>& data, const DesCipher& cipher, int threads) {
+    uint8_t last[8];
+    size_t full = padFinalBlock(data, last);
+    vector<uint8_t> result(full + 8);
+
+    // ֱӴ밴ݿ鲢дһȡ仺
+    forEachChunk(full, threads, [&](size_t offset, size_t len) {
+        cipher.encryptBlocks(data.data() + offset, result.data() + offset, len / 8);
+    });
+    cipher.encryptBlocks(last, result.data() + full, 1);
 
     return result;
 }
 
 // ECBģʽ
-vector<uint8_t> ecbDecrypt(const vector<uint8_t>& data, const vector<uint64_t>& subkeys) {
+vector<uint8_t> ecbDecrypt(const vector<uint8_t>& data, const DesCipher& cipher, int threads) {
     if (data.size() % 8 != 0) {
         throw runtime_error("ݳȱ8ı");
     }
 
-    vector<uint8_t> result;
-    result.reserve(data.size());
+    vector<uint8_t> result(data.size());
+    forEachChunk(data.size(), threads, [&](size_t offset, size_t len) {
+        cipher.decryptBlocks(data.data() + offset, result.data() + offset, len / 8);
+    });
 
-    // 鴦
-    for (size_t i = 0; i < data.size(); i += 8) {
-        uint64_t block = 0;
-        for (int j = 0; j < 8; j++) {
-            block = (block << 8) | data[i + j];
-        }
+    // Ƴ
+    trimPadding(result);
+    return result;
+}
 
-        uint64_t decrypted = desBlockDecrypt(block, subkeys);
+// CBCģʽ
+vector<uint8_t> cbcEncrypt(const vector<uint8_t>& data, const DesCipher& cipher, uint64_t iv) {
+    uint8_t last[8];
+    size_t full = padFinalBlock(data, last);
+    vector<uint8_t> result(full + 8);
 
-        // ܺĿӵ
-        for (int j = 7; j >= 0; j--) {
-            result.push_back(static_cast<uint8_t>((decrypted >> (j * 8)) & 0xFF));
+    uint64_t prevBlock = iv;
+
+    // 鴦(ÿһģֻܴ)һȡ仺
+    for (size_t i = 0; i <= full; i += 8) {
+        const uint8_t* in = i < full ? &data[i] : last;
+
+        // ǰһܽ
+        prevBlock = cipher.encryptBlock(loadBE64(in) ^ prevBlock);
+        storeBE64(&result[i], prevBlock);
+    }
+
+    return result;
+}
+
+// CBCÿĿܣٳݻL1ǰһ
+const size_t CBC_BATCH_BLOCKS = 512;
+
+// CBCn飬prevΪһ֮ǰֵ(IVһ)
+void cbcDecryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const DesCipher& cipher, uint64_t prev) {
+    // Ľܻ
+    for (size_t start = 0; start < n; start += CBC_BATCH_BLOCKS) {
+        size_t count = min(CBC_BATCH_BLOCKS, n - start);
+        const uint8_t* src = in + start * 8;
+        uint8_t* dst = out + start * 8;
+        cipher.decryptBlocks(src, dst, count);
+
+        // ǰһ
+        storeBE64(dst, loadBE64(dst) ^ (start == 0 ? prev : loadBE64(src - 8)));
+        for (size_t i = 1; i < count; i++) {
+            storeBE64(dst + i * 8, loadBE64(dst + i * 8) ^ loadBE64(src + (i - 1) * 8));
         }
     }
+}
+
+// CBCģʽ
+vector<uint8_t> cbcDecrypt(const vector<uint8_t>& data, const DesCipher& cipher, uint64_t iv, int threads) {
+    if (data.size() % 8 != 0) {
+        throw runtime_error("ݳȱ8ı");
+    }
+
+    vector<uint8_t> result(data.size());
+
+    // ֻǰһģĶУÿݿֵǰ8ֽģ
+    // ԶУ봮ȫһ
+    forEachChunk(data.size(), threads, [&](size_t offset, size_t len) {
+        uint64_t prev = offset == 0 ? iv : loadBE64(data.data() + offset - 8);
+        cbcDecryptBlocks(data.data() + offset, result.data() + offset, len / 8, cipher, prev);
+    });
 
     // Ƴ
-    return removePadding(result);
+    trimPadding(result);
+    return result;
 }
 
-// CBCģʽ
-vector<uint8_t> cbcEncrypt(const vector<uint8_t>& data, const vector<uint64_t>& subkeys, uint64_t iv) {
-    vector<uint8_t> padded = addPadding(data);
-    vector<uint8_t> result;
-    result.reserve(padded.size());
+// CFB-64n飬prevΪһ֮ǰֵ(IVһ)
+void cfb64DecryptBlocks(const uint8_t* in, uint8_t* out, size_t n, const DesCipher& cipher, uint64_t prev) {
+    for (size_t start = 0; start < n; start += CBC_BATCH_BLOCKS) {
+        size_t count = min(CBC_BATCH_BLOCKS, n - start);
+        const uint8_t* src = in + start * 8;
+        uint8_t* dst = out + start * 8;
+
+        // ԿǰһĵļܽĶУһֱ
+        storeBE64(dst, cipher.encryptBlock(start == 0 ? prev : loadBE64(src - 8)));
+        cipher.encryptBlocks(src, dst + 8, count - 1);
+        for (size_t i = 0; i < count; i++) {
+            storeBE64(dst + i * 8, loadBE64(dst + i * 8) ^ loadBE64(src + i * 8));
+        }
+    }
+}
 
-    uint64_t prevBlock = iv;
+// CFBģʽ/
+vector<uint8_t> cfbProcess(const vector<uint8_t>& data, const DesCipher& cipher, uint64_t iv, OperationMode mode,
+    int segment, int threads) {
+    vector<uint8_t> result(data.size());
 
-    // 鴦
-    for (size_t i = 0; i < padded.size(); i += 8) {
-        // ǰ
-        uint64_t block = 0;
-        for (int j = 0; j < 8; j++) {
-            block = (block << 8) | padded[i + j];
-        }
+    if (segment == 8) {
+        uint64_t registerValue = iv;  // λĴ
 
-        // ǰһܽ
-        block ^= prevBlock;
+        // ֽڴ
+        for (size_t i = 0; i < data.size(); i++) {
+            // ܼĴݣȡܽλֽ/
+            uint8_t keystreamByte = static_cast<uint8_t>(cipher.encryptBlock(registerValue) >> 56);
+            result[i] = data[i] ^ keystreamByte;
 
-        // 
-        uint64_t encrypted = desBlockEncrypt(block, subkeys);
-        prevBlock = encrypted;
+            // λĴ
+            registerValue = (registerValue << 8) | (mode == ENCRYPT ? result[i] : data[i]);
+        }
+        return result;
+    }
+
+    // 64λֶΣԿһֻԿǰֽڣҪ
+    size_t full = data.size() / 8 * 8;
+    uint64_t registerValue = iv;
+    if (mode == ENCRYPT) {
+        // ʱÿһģֻܴ
+        for (size_t i = 0; i < full; i += 8) {
+            registerValue = cipher.encryptBlock(registerValue) ^ loadBE64(&data[i]);
+            storeBE64(&result[i], registerValue);
+        }
+    }
+    else {
+        // ʱֵǰһģ԰ݿ鲢
+        forEachChunk(full, threads, [&](size_t offset, size_t len) {
+            uint64_t prev = offset == 0 ? iv : loadBE64(data.data() + offset - 8);
+            cfb64DecryptBlocks(data.data() + offset, result.data() + offset, len / 8, cipher, prev);
+        });
+        if (full > 0) {
+            registerValue = loadBE64(&data[full - 8]);
+        }
+    }
 
-        // ܺĿӵ
-        for (int j = 7; j >= 0; j--) {
-            result.push_back(static_cast<uint8_t>((encrypted >> (j * 8)) & 0xFF));
+    if (full < data.size()) {
+        uint8_t keystream[8];
+        storeBE64(keystream, cipher.encryptBlock(registerValue));
+        for (size_t i = full; i < data.size(); i++) {
+            result[i] = data[i] ^ keystream[i - full];
         }
     }
 
     return result;
 }
 
-// CBCģʽ
-vector<uint8_t> cbcDecrypt(const vector<uint8_t>& data, const vector<uint64_t>& subkeys, uint64_t iv) {
-    if (data.size() % 8 != 0) {
-        throw runtime_error("ݳȱ8ı");
+// lenֽOFBԿдoutĴܣ8λֶȡÿνֽڣ64λֶȡ
+void ofbKeystream(const DesCipher& cipher, uint64_t& registerValue, int segment, uint8_t* out, size_t len) {
+    if (segment == 8) {
+        for (size_t i = 0; i < len; i++) {
+            registerValue = cipher.encryptBlock(registerValue);
+            out[i] = static_cast<uint8_t>(registerValue >> 56);
+        }
+        return;
     }
 
-    vector<uint8_t> result;
-    result.reserve(data.size());
+    uint8_t block[8];
+    for (size_t i = 0; i < len; i += 8) {
+        registerValue = cipher.encryptBlock(registerValue);
+        storeBE64(block, registerValue);
+        memcpy(out + i, block, min<size_t>(8, len - i));
+    }
+}
 
-    uint64_t prevBlock = iv;
+// OFBÿɡ8ı
+const size_t OFB_CHUNK_SIZE = 64 * 1024;
 
-    // 鴦
-    for (size_t i = 0; i < data.size(); i += 8) {
-        // ǰ
-        uint64_t block = 0;
-        for (int j = 0; j < 8; j++) {
-            block = (block << 8) | data[i + j];
+// OFBģʽ/
+vector<uint8_t> ofbProcess(const vector<uint8_t>& data, const DesCipher& cipher, uint64_t iv, int segment, int threads) {
+    // ȰԿд
+    vector<uint8_t> result(data.size());
+    auto xorChunk = [&](size_t offset, size_t len) {
+        for (size_t i = offset; i < offset + len; i++) {
+            result[i] ^= data[i];
         }
+    };
 
-        // 
-        uint64_t decrypted = desBlockDecrypt(block, subkeys);
+    uint64_t registerValue = iv;  // λĴ
 
-        // ǰһ
-        decrypted ^= prevBlock;
-        prevBlock = block;
+    if (threads < 2) {
+        for (size_t offset = 0; offset < data.size(); offset += OFB_CHUNK_SIZE) {
+            size_t len = min(OFB_CHUNK_SIZE, data.size() - offset);
+            ofbKeystream(cipher, registerValue, segment, &result[offset], len);
+            xorChunk(offset, len);
+        }
+        return result;
+    }
 
-        // ܺĿӵ
-        for (int j = 7; j >= 0; j--) {
-            result.push_back(static_cast<uint8_t>((decrypted >> (j * 8)) & 0xFF));
+    // Կ޹أɵ߳ɣǰ̸߳ں
+    // producedΪԿֽ
+    atomic<size_t> produced(0);
+    thread generator([&]() {
+        uint64_t reg = iv;
+        for (size_t offset = 0; offset < data.size(); offset += OFB_CHUNK_SIZE) {
+            size_t len = min(OFB_CHUNK_SIZE, data.size() - offset);
+            ofbKeystream(cipher, reg, segment, &result[offset], len);
+            produced.store(offset + len, memory_order_release);
         }
+    });
+
+    for (size_t offset = 0; offset < data.size(); offset += OFB_CHUNK_SIZE) {
+        size_t len = min(OFB_CHUNK_SIZE, data.size() - offset);
+        while (produced.load(memory_order_acquire) < offset + len) {
+            this_thread::yield();
+        }
+        xorChunk(offset, len);
     }
+    generator.join();
 
-    // Ƴ
-    return removePadding(result);
+    return result;
 }
 
-// CFBģʽ/
-vector<uint8_t> cfbProcess(const vector<uint8_t>& data, const vector<uint64_t>& subkeys, uint64_t iv, OperationMode mode) {
-    vector<uint8_t> result;
-    result.reserve(data.size());
+// ===== ֪Կ =====
+// Կ = ֪ǰ׺ + ַöٵδַ֪λƬʱÿͨʹòͬԿ
+// ĶͨͬҪתãԿλֱȡԿλƽ棬ҪԿ
+// δֳַ֪ɸλ͵λ֣ͨȡڵĸλϣֻ֮öٵλ
+// λַͨͬÿֻؽ仯˵Ǽַλƽ(ֻͨһ)
+// ͨͬĸλַÿֻһ
+
+// λƬÿĺѡԿ
+const uint64_t SEARCH_LANES = BITSLICE_BLOCKS;
+
+// ȱͱļ룩
+const int SEARCH_REPORT_SECONDS = 5;
+
+// Կռ䣺indexѡԿδַַ֪չһַ仯
+struct KeySpace {
+    KeySpace(const string& prefix, const string& charset) : prefix(prefix), fullCharset(charset), size(1), inner(1) {
+        // ÿֽڵλżУλܣֻһλַȼֻۣһ
+        bool seen[128] = {};
+        for (char ch : charset) {
+            uint8_t c = static_cast<uint8_t>(ch);
+            if (!seen[c >> 1]) {
+                seen[c >> 1] = true;
+                this->charset += ch;
+            }
+        }
+        unknown = 8 - static_cast<int>(prefix.length());
+        for (int i = 0; i < unknown; i++) {
+            size *= this->charset.length();
+        }
 
-    uint64_t registerValue = iv;  // λĴ
+        // λ֣һÿͨöinnerλϡȡ㹻ԼؽλƽĴ
+        // Ҫ֤λռһͨ
+        innerChars = 0;
+        while (innerChars < unknown && inner < 1024 && size / inner / this->charset.length() >= SEARCH_LANES) {
+            inner *= this->charset.length();
+            innerChars++;
+        }
+        outer = size / inner;
+    }
 
-    // ֽڴ
-    for (uint8_t byte : data) {
-        // ܼĴ
-        uint64_t encryptedReg = desBlockEncrypt(registerValue, subkeys);
+    // indexѡԿ
+    string keyAt(uint64_t index) const {
+        string key = prefix;
+        key.resize(8);
+        for (int p = 7; p >= static_cast<int>(prefix.length()); p--) {
+            key[p] = charset[index % charset.length()];
+            index /= charset.length();
+        }
+        return key;
+    }
 
-        // ȡܽλֽ
-        uint8_t keystreamByte = static_cast<uint8_t>((encryptedReg >> 56) & 0xFF);
+    // ÿΪSEARCH_LANESڵĸλϣһĺѡԿ
+    uint64_t tasks() const {
+        return (outer + SEARCH_LANES - 1) / SEARCH_LANES;
+    }
 
-        // /
-        uint8_t outputByte = byte ^ keystreamByte;
-        result.push_back(outputByte);
+    uint64_t taskKeys() const {
+        return SEARCH_LANES * inner;
+    }
 
-        // λĴ
-        registerValue = (registerValue << 8) | (mode == ENCRYPT ? outputByte : byte);
-        registerValue &= 0xFFFFFFFFFFFFFFFF;  // 64λ
+    // ԭַcֻżУλַcַгֵ˳
+    string equivalents(char c) const {
+        string result;
+        for (char ch : fullCharset) {
+            if ((static_cast<uint8_t>(ch) >> 1) == (static_cast<uint8_t>(c) >> 1) && result.find(ch) == string::npos) {
+                result += ch;
+            }
+        }
+        return result;
     }
 
-    return result;
+    string prefix;
+    string fullCharset;  // ûַ
+    string charset;      // ȥȼַַ
+    int unknown;         // δַ֪
+    uint64_t size;       // ѡԿ
+    int innerChars;      // λַ
+    uint64_t inner;      // λ
+    uint64_t outer;      // λ
+};
+
+// ɸͨλλƽ棺words[w]ĵjλӦ64w+jͨ
+inline void laneFromWords(const uint64_t* words, uint64_t& lane) {
+    lane = words[0];
 }
 
-// OFBģʽ/
-vector<uint8_t> ofbProcess(const vector<uint8_t>& data, const vector<uint64_t>& subkeys, uint64_t iv) {
-    vector<uint8_t> result;
-    result.reserve(data.size());
+inline void laneToWords(uint64_t lane, uint64_t* words) {
+    words[0] = lane;
+}
 
-    uint64_t registerValue = iv;  // λĴ
+#if DES_HAVE_SSE2
+inline void laneFromWords(const uint64_t* words, Lane128& lane) {
+    lane.v = _mm_set_epi64x(static_cast<long long>(words[1]), static_cast<long long>(words[0]));
+}
+
+inline void laneToWords(Lane128 lane, uint64_t* words) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(words), lane.v);
+}
+#endif
+
+// task񣬷ҵĺѡԿ±꣬ûҵUINT64_MAXstopλʱǰ
+uint64_t searchTask(const KeySpace& space, uint64_t plain, uint64_t cipher, uint64_t task, const atomic<bool>& stop) {
+    const size_t WORDS = SEARCH_LANES / 64;
+    const uint64_t radix = space.charset.length();
+    const int first = static_cast<int>(space.prefix.length());
+    const int split = 8 - space.innerChars;  // λַ￪ʼ
+
+    // ǰ׺Կλͨͬ
+    BitsliceLane key[64];
+    for (int b = 0; b < 64; b++) {
+        laneSet(key[b], false);
+    }
+    for (int p = 0; p < first; p++) {
+        uint8_t c = static_cast<uint8_t>(space.prefix[p]);
+        for (int b = 0; b < 8; b++) {
+            laneSet(key[p * 8 + b], (c >> (7 - b)) & 1);
+        }
+    }
 
-    // ֽڴ
-    for (uint8_t byte : data) {
-        // ܼĴ
-        uint64_t encryptedReg = desBlockEncrypt(registerValue, subkeys);
+    // λַÿͨͬjͨȡtask * SEARCH_LANES + jλϣΧͨ
+    uint64_t firstOuter = task * SEARCH_LANES;
+    size_t lanes = static_cast<size_t>(min<uint64_t>(SEARCH_LANES, space.outer - firstOuter));
+    for (int p = first; p < split; p++) {
+        uint64_t words[8][WORDS];
+        memset(words, 0, sizeof(words));
+        uint64_t div = 1;
+        for (int q = p + 1; q < split; q++) {
+            div *= radix;
+        }
+        for (size_t j = 0; j < lanes; j++) {
+            uint8_t c = static_cast<uint8_t>(space.charset[(firstOuter + j) / div % radix]);
+            for (int b = 0; b < 8; b++) {
+                words[b][j / 64] |= static_cast<uint64_t>((c >> (7 - b)) & 1) << (j % 64);
+            }
+        }
+        for (int b = 0; b < 8; b++) {
+            laneFromWords(words[b], key[p * 8 + b]);
+        }
+    }
 
-        // ȡܽλֽΪԿ
-        uint8_t keystreamByte = static_cast<uint8_t>((encryptedReg >> 56) & 0xFF);
+    // ĺĿĵλƽͨͬ
+    BitsliceLane plainPlanes[64], target[64];
+    for (int b = 0; b < 64; b++) {
+        laneSet(plainPlanes[b], (plain >> (63 - b)) & 1);
+        laneSet(target[b], (cipher >> (63 - b)) & 1);
+    }
 
-        // /
-        result.push_back(byte ^ keystreamByte);
+    // λַö٣ֻؽ仯˵ַ(λʱŻᳬһ)
+    uint32_t digits[8] = {};
+    int changed = split;
+    BitsliceLane planes[64];
+    for (uint64_t t = 0; t < space.inner; t++) {
+        if (stop.load(memory_order_relaxed)) {
+            return UINT64_MAX;
+        }
 
-        // λĴ
-        registerValue = encryptedReg;
+        for (int p = changed; p < 8; p++) {
+            uint8_t c = static_cast<uint8_t>(space.charset[digits[p]]);
+            for (int b = 0; b < 8; b++) {
+                laneSet(key[p * 8 + b], (c >> (7 - b)) & 1);
+            }
+        }
+
+        // ͨͬһģ֪λȽ
+        memcpy(planes, plainPlanes, sizeof(planes));
+        desBitslice(planes, key, ENCRYPT);
+        BitsliceLane diff = planes[0] ^ target[0];
+        for (int b = 1; b < 64; b++) {
+            diff = diff | (planes[b] ^ target[b]);
+        }
+
+        uint64_t words[WORDS];
+        laneToWords(diff, words);
+        for (size_t j = 0; j < lanes; j++) {
+            if (!((words[j / 64] >> (j % 64)) & 1)) {
+                return (firstOuter + j) * space.inner + t;
+            }
+        }
+
+        // λһ
+        changed = 8;
+        for (int p = 7; p >= split; p--) {
+            changed = p;
+            if (++digits[p] < radix) {
+                break;
+            }
+            digits[p] = 0;
+        }
     }
+    return UINT64_MAX;
+}
 
-    return result;
+// 㣺¼ʹǰȫĺѡԿжϺԴ
+string searchCheckpointText(const Args& args, uint64_t done, const string& found) {
+    ostringstream out;
+    out << "DES-KEY-SEARCH 1" << endl;
+    out << "known-plain " << args.knownPlain << endl;
+    out << "known-cipher " << args.knownCipher << endl;
+    out << "charset " << toHex(args.charset) << endl;
+    out << "prefix " << toHex(args.prefix) << endl;
+    out << "done " << done << endl;
+    if (!found.empty()) {
+        out << "found " << toHex(found) << endl;
+    }
+    return out.str();
+}
+
+void writeSearchCheckpoint(const Args& args, uint64_t done, const string& found) {
+    // дʱļٸ;ʱ²ȱļ
+    string temp = args.checkpointFile + ".tmp";
+    {
+        ofstream file(temp, ios::binary);
+        if (!file) {
+            throw runtime_error("޷ļ: " + temp);
+        }
+        file << searchCheckpointText(args, done, found);
+    }
+    remove(args.checkpointFile.c_str());
+    if (rename(temp.c_str(), args.checkpointFile.c_str()) != 0) {
+        throw runtime_error("޷дļ: " + args.checkpointFile);
+    }
+}
+
+// ȡ㣬ĺѡԿļʱ0
+uint64_t loadSearchCheckpoint(const Args& args, string& found) {
+    ifstream file(args.checkpointFile, ios::binary);
+    if (!file) {
+        return 0;
+    }
+
+    string header, line;
+    getline(file, header);
+    if (header != "DES-KEY-SEARCH 1") {
+        throw runtime_error("Чļļ: " + args.checkpointFile);
+    }
+    uint64_t done = 0;
+    string expected = searchCheckpointText(args, 0, "");
+    istringstream params(expected);
+    getline(params, line);
+    for (int i = 0; i < 4; i++) {
+        string want, got;
+        getline(params, want);
+        getline(file, got);
+        if (want != got) {
+            throw runtime_error("뵱ǰһ: " + args.checkpointFile);
+        }
+    }
+    while (getline(file, line)) {
+        istringstream fields(line);
+        string name, value;
+        fields >> name >> value;
+        if (name == "done") {
+            done = stoull(value);
+        }
+        else if (name == "found") {
+            found = fromHex(value);
+        }
+    }
+    return done;
+}
+
+// ֪Կ
+void runKeySearch(const Args& args) {
+    KeySpace space(args.prefix, args.charset);
+    uint64_t plain = parseHexBlock(args.knownPlain, "֪");
+    uint64_t cipher = parseHexBlock(args.knownCipher, "֪");
+
+    cout << "Կռ: " << space.size << " ѡԿǰ׺ \"" << space.prefix << "\""
+        << space.unknown << " δַַ֪ " << space.charset.length() << " ַ" << endl;
+    if (space.charset.length() < args.charset.length()) {
+        cout << "ַ " << args.charset.length() - space.charset.length()
+            << " ַַֻżУλܽͬ" << endl;
+    }
+
+    string found;
+    uint64_t resumeFrom = 0;
+    if (!args.checkpointFile.empty()) {
+        resumeFrom = min(loadSearchCheckpoint(args, found), space.size);
+        if (resumeFrom > 0 || !found.empty()) {
+            cout << "Ӽ:  " << resumeFrom << " ѡԿ" << endl;
+        }
+    }
+
+    auto start = steady_clock::now();
+    atomic<bool> stop(!found.empty());
+    atomic<uint64_t> foundIndex(UINT64_MAX);
+    atomic<uint64_t> tested(0);
+
+    // ¼Ľ߽
+    uint64_t tasks = space.tasks();
+    uint64_t firstTask = min(resumeFrom / space.taskKeys(), tasks);
+    resumeFrom = min(firstTask * space.taskKeys(), space.size);
+    atomic<uint64_t> nextTask(firstTask);
+
+    // ߳ڴڼԱ浽Ľ
+    int workers = args.threads;
+    unique_ptr<atomic<uint64_t>[]> current(new atomic<uint64_t>[workers]);
+    for (int t = 0; t < workers; t++) {
+        current[t] = UINT64_MAX;
+    }
+
+    // ߳ͨԭӼȡһ߳Զ죬Ȼ
+    auto worker = [&](int id) {
+        for (uint64_t task = nextTask++; task < tasks && !stop; task = nextTask++) {
+            current[id] = task;
+            uint64_t from = task * space.taskKeys();
+            uint64_t to = min(from + space.taskKeys(), space.size);
+            uint64_t index = searchTask(space, plain, cipher, task, stop);
+            if (index != UINT64_MAX) {
+                foundIndex = index;
+                stop = true;
+                // ҵʱ֮ǰͨѼ
+                uint64_t lanes = min(SEARCH_LANES, space.outer - task * SEARCH_LANES);
+                tested += (index % space.inner + 1) * lanes;
+            }
+            else if (!stop) {
+                tested += to - from;
+            }
+        }
+        current[id] = UINT64_MAX;
+    };
+
+    // ǰɵĺѡԿδɵС֮ǰĲ
+    auto completed = [&]() {
+        uint64_t lowest = min(nextTask.load(), tasks);
+        for (int t = 0; t < workers; t++) {
+            lowest = min(lowest, current[t].load());
+        }
+        return min(lowest * space.taskKeys(), space.size);
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < workers; t++) {
+        pool.emplace_back(worker, t);
+    }
+
+    // ̶߳ڱȡ
+    auto lastReport = start;
+    while (tested < space.size - resumeFrom && !stop) {
+        this_thread::sleep_for(milliseconds(10));
+        auto now = steady_clock::now();
+        if (now - lastReport >= seconds(SEARCH_REPORT_SECONDS)) {
+            lastReport = now;
+            double elapsed = duration<double>(now - start).count();
+            uint64_t done = tested;
+            cout << "Ѳ " << resumeFrom + done << " / " << space.size << " ("
+                << fixed << setprecision(2) << 100.0 * (resumeFrom + done) / space.size << "%)ٶ "
+                << setprecision(0) << done / elapsed << " Կ/" << endl;
+            if (!args.checkpointFile.empty()) {
+                writeSearchCheckpoint(args, completed(), "");
+            }
+        }
+    }
+    for (thread& t : pool) {
+        t.join();
+    }
+
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+    if (foundIndex != UINT64_MAX) {
+        found = space.keyAt(foundIndex);
+    }
+    if (!args.checkpointFile.empty()) {
+        writeSearchCheckpoint(args, found.empty() ? space.size : completed(), found);
+    }
+
+    if (!found.empty()) {
+        cout << "ҵԿ: " << found << "ʮ " << toHex(found) << "" << endl;
+
+        // ȼַֻ˵һʵʹõĿκһгλõĿַ
+        uint64_t combinations = 1;
+        vector<string> alternatives;
+        for (size_t p = space.prefix.length(); p < 8; p++) {
+            string eq = space.equivalents(found[p]);
+            if (eq.length() > 1) {
+                combinations *= eq.length();
+                string line = "  " + to_string(p + 1) + "ַ:";
+                for (char ch : eq) {
+                    line += string(" ") + ch;
+                }
+                alternatives.push_back(line);
+            }
+        }
+        if (!alternatives.empty()) {
+            cout << "DESʹÿֽڵżУλԿַ " << combinations
+                << " ȼԿ֮һʵʹõĿַ:" << endl;
+            for (const string& line : alternatives) {
+                cout << line << endl;
+            }
+        }
+    }
+    else {
+        cout << "δҵԿ" << endl;
+    }
+    cout << "Ѳ: " << resumeFrom + tested << " ѡԿ" << endl;
+    cout << "߳: " << workers << endl;
+    cout << "ʱ: " << static_cast<uint64_t>(elapsed * 1000) << " " << endl;
+    if (elapsed > 0) {
+        cout << "ٶ: " << fixed << setprecision(0) << tested / elapsed << " Կ/" << endl;
+    }
 }
 
 int main(int argc, char* argv[]) {
     try {
         // в
         Args args = parseArgs(argc, argv);
+        if (args.search) {
+            runKeySearch(args);
+            return 0;
+        }
 
         // ȡļ
         vector<uint8_t> inputData = readFile(args.inputFile);
         cout << "ȡļ: " << args.inputFile << " (" << inputData.size() << " ֽ)" << endl;
 
-        // תԿ
-        uint64_t key = stringToKey(args.key);
-
-        // Կ
-        vector<uint64_t> subkeys = generateSubkeys(key);
+        // תԿɸԿ
+        DesCipher cipher(args.key, args.variant, args.backend);
 
         // ʼ
         uint64_t iv = 0;
@@ -645,25 +2498,25 @@ int main(int argc, char* argv[]) {
         switch (args.desMode) {
         case ECB:
             if (args.opMode == ENCRYPT) {
-                outputData = ecbEncrypt(inputData, subkeys);
+                outputData = ecbEncrypt(inputData, cipher, args.threads);
             }
             else {
-                outputData = ecbDecrypt(inputData, subkeys);
+                outputData = ecbDecrypt(inputData, cipher, args.threads);
             }
             break;
         case CBC:
             if (args.opMode == ENCRYPT) {
-                outputData = cbcEncrypt(inputData, subkeys, iv);
+                outputData = cbcEncrypt(inputData, cipher, iv);
             }
             else {
-                outputData = cbcDecrypt(inputData, subkeys, iv);
+                outputData = cbcDecrypt(inputData, cipher, iv, args.threads);
             }
             break;
         case CFB:
-            outputData = cfbProcess(inputData, subkeys, iv, args.opMode);
+            outputData = cfbProcess(inputData, cipher, iv, args.opMode, args.segment, args.threads);
             break;
         case OFB:
-            outputData = ofbProcess(inputData, subkeys, iv);
+            outputData = ofbProcess(inputData, cipher, iv, args.segment, args.threads);
             break;
         }
 
@@ -676,12 +2529,20 @@ int main(int argc, char* argv[]) {
 
         // Ϣ
         cout << ": " << (args.opMode == ENCRYPT ? "" : "") << " " << endl;
+        cout << ": " << (cipher.backend == DES_BACKEND_BITSLICE ? "λƬ" : "") << endl;
+        cout << ": ";
+        switch (args.variant) {
+        case DES_SINGLE: cout << "DES"; break;
+        case TDES_EDE2: cout << "3DES-EDE2"; break;
+        case TDES_EDE3: cout << "3DES-EDE3"; break;
+        }
+        cout << endl;
         cout << "DESģʽ: ";
         switch (args.desMode) {
         case ECB: cout << "ECB"; break;
         case CBC: cout << "CBC"; break;
-        case CFB: cout << "CFB"; break;
-        case OFB: cout << "OFB"; break;
+        case CFB: cout << "CFB-" << args.segment; break;
+        case OFB: cout << "OFB-" << args.segment; break;
         }
         cout << endl;
         cout << "ʱ: " << duration.count() << " " << endl;
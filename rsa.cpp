@@ -4,13 +4,27 @@
 #include <cstdint>
 #include <fstream>
 #include <sstream>
-#include <random>
 #include <algorithm>
 #include <chrono>
 #include <stdexcept>
 #include <iomanip>
 #include <cstring>
 
+// ϵͳ
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <bcrypt.h>
+#pragma comment(lib, "bcrypt.lib")
+#elif defined(__linux__)
+#include <sys/random.h>
+#include <cerrno>
+#else
+#include <cstdio>
+#endif
+
 using namespace std;
 using namespace chrono;
 
@@ -34,10 +48,40 @@ struct Args {
     int keySize;             // Կȣأ
 };
 
-// 
+// ϵͳṩѧȫҪԤĳ
+void secureRandomBytes(uint8_t* out, size_t len) {
+#if defined(_WIN32)
+    if (BCryptGenRandom(nullptr, out, static_cast<ULONG>(len), BCRYPT_USE_SYSTEM_PREFERRED_RNG) != 0) {
+        throw runtime_error("ȡϵͳʧ");
+    }
+#elif defined(__linux__)
+    while (len > 0) {
+        ssize_t n = getrandom(out, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw runtime_error("ȡϵͳʧ");
+        }
+        out += n;
+        len -= static_cast<size_t>(n);
+    }
+#else
+    FILE* f = fopen("/dev/urandom", "rb");
+    if (f == nullptr) {
+        throw runtime_error("ȡϵͳʧ");
+    }
+    size_t n = fread(out, 1, len, f);
+    fclose(f);
+    if (n != len) {
+        throw runtime_error("ȡϵͳʧ");
+    }
+#endif
+}
+
+// ȡϵͳɵ˽ԿܱԤ
 uint64_t generateRandom64() {
-    static mt19937_64 rng(system_clock::now().time_since_epoch().count());
-    return rng();
+    uint64_t r;
+    secureRandomBytes(reinterpret_cast<uint8_t*>(&r), sizeof(r));
+    return r;
 }
 
 // Ƚϣa > b
@@ -85,15 +129,11 @@ BigInt subtract(const BigInt& a, const BigInt& b) {
         uint64_t aVal = a[i];
         uint64_t bVal = (i < b.size()) ? b[i] : 0;
 
-        aVal -= borrow;
-        borrow = 0;
+        // λaVal < bValԵλĽλ
+        uint64_t diff = aVal - bVal - borrow;
+        borrow = (aVal < bVal || (aVal == bVal && borrow)) ? 1 : 0;
 
-        if (aVal < bVal) {
-            aVal += UINT64_MAX + 1;  // λ
-            borrow = 1;
-        }
-
-        result.push_back(aVal - bVal);
+        result.push_back(diff);
     }
 
     // Ƴǰ
@@ -146,52 +186,110 @@ BigInt multiply(const BigInt& a, const BigInt& b) {
     return result;
 }
 
-// ̺
+// ̺Knuth㷨Dÿ̵һ64λ
 pair<BigInt, BigInt> divide(const BigInt& a, const BigInt& b) {
-    if (equals(b, BigInt{ 0 })) {
+    BigInt u = a, v = b;
+    while (u.size() > 1 && u.back() == 0) u.pop_back();
+    while (v.size() > 1 && v.back() == 0) v.pop_back();
+
+    if (equals(v, BigInt{ 0 })) {
         throw runtime_error("");
     }
 
-    if (greaterThan(b, a)) {
-        return { BigInt{0}, a };
+    if (greaterThan(v, u)) {
+        return { BigInt{0}, u };
     }
 
-    BigInt quotient;
-    BigInt remainder;
-
-    // λʼ
-    for (int i = a.size() - 1; i >= 0; --i) {
-        // ǰλӵ
-        remainder.insert(remainder.begin(), a[i]);
-
-        // Ƴǰ
-        while (remainder.size() > 1 && remainder.back() == 0) {
-            remainder.pop_back();
+    size_t n = v.size();
+    size_t m = u.size() - n;
+    BigInt quotient(m + 1, 0);
+
+    // ֻһʱֶ̳
+    if (n == 1) {
+        uint64_t rem = 0;
+        for (size_t i = u.size(); i-- > 0;) {
+            __uint128_t cur = ((__uint128_t)rem << 64) | u[i];
+            quotient[i] = (uint64_t)(cur / v[0]);
+            rem = (uint64_t)(cur % v[0]);
         }
+        while (quotient.size() > 1 && quotient.back() == 0) {
+            quotient.pop_back();
+        }
+        return { quotient, BigInt{ rem } };
+    }
 
-        // 㵱ǰλ
-        uint64_t q = 0;
-        BigInt temp = b;
+    // 񻯣ʹֵλΪ1ƫ2
+    int shift = 0;
+    for (uint64_t top = v.back(); !(top >> 63); top <<= 1) {
+        ++shift;
+    }
+    u.push_back(0);
+    if (shift > 0) {
+        for (size_t i = u.size() - 1; i > 0; --i) {
+            u[i] = (u[i] << shift) | (u[i - 1] >> (64 - shift));
+        }
+        u[0] <<= shift;
+        for (size_t i = n - 1; i > 0; --i) {
+            v[i] = (v[i] << shift) | (v[i - 1] >> (64 - shift));
+        }
+        v[0] <<= shift;
+    }
 
-        // ҵqʹq*b <= remainder
-        while (greaterThan(remainder, temp) || equals(remainder, temp)) {
-            q++;
-            temp = add(temp, b);
+    // λʼ
+    for (size_t j = m + 1; j-- > 0;) {
+        // ֳԳ̣ôθ
+        __uint128_t top = ((__uint128_t)u[j + n] << 64) | u[j + n - 1];
+        __uint128_t qhat = top / v[n - 1];
+        __uint128_t rhat = top % v[n - 1];
+        while (qhat >> 64 || qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2])) {
+            --qhat;
+            rhat += v[n - 1];
+            if (rhat >> 64) break;
         }
 
-        quotient.insert(quotient.begin(), q);
+        // ȥqhatĳ
+        uint64_t borrow = 0, carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            __uint128_t product = qhat * v[i] + carry;
+            carry = (uint64_t)(product >> 64);
+            uint64_t sub = (uint64_t)product;
+            uint64_t diff = u[i + j] - sub - borrow;
+            borrow = (u[i + j] < sub || (u[i + j] == sub && borrow)) ? 1 : 0;
+            u[i + j] = diff;
+        }
+        uint64_t diff = u[j + n] - carry - borrow;
+        bool negative = u[j + n] < carry || (u[j + n] == carry && borrow);
+        u[j + n] = diff;
+
+        // ƫ1ʱٷӻһ
+        if (negative) {
+            --qhat;
+            uint64_t c = 0;
+            for (size_t i = 0; i < n; ++i) {
+                __uint128_t sum = (__uint128_t)u[i + j] + v[i] + c;
+                u[i + j] = (uint64_t)sum;
+                c = (uint64_t)(sum >> 64);
+            }
+            u[j + n] += c;
+        }
+        quotient[j] = (uint64_t)qhat;
+    }
 
-        // 
-        if (q > 0) {
-            temp = subtract(temp, b);  // һ
-            remainder = subtract(remainder, temp);
+    // Ϊuĵnƻȥ
+    BigInt remainder(u.begin(), u.begin() + n);
+    if (shift > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            remainder[i] = (remainder[i] >> shift) | (i + 1 < n ? remainder[i + 1] << (64 - shift) : 0);
         }
     }
 
-    // Ƴ̵ǰ
+    // Ƴ̺ǰ
     while (quotient.size() > 1 && quotient.back() == 0) {
         quotient.pop_back();
     }
+    while (remainder.size() > 1 && remainder.back() == 0) {
+        remainder.pop_back();
+    }
 
     return { quotient, remainder };
 }
@@ -201,25 +299,257 @@ BigInt bigMod(const BigInt& a, const BigInt& m) {
     return divide(a, m).second;
 }
 
-// ģ (base^exponent mod mod)
-BigInt modPow(const BigInt& base, const BigInt& exponent, const BigInt& mod) {
-    BigInt result = { 1 };
-    BigInt currentBase = bigMod(base, mod);  // ʹĺ
-    BigInt currentExponent = exponent;
+// Ч
+size_t bitLength(const BigInt& num) {
+    size_t top = num.size();
+    while (top > 0 && num[top - 1] == 0) {
+        --top;
+    }
+    if (top == 0) return 0;
 
-    while (!equals(currentExponent, BigInt{ 0 })) {
-        // ָԵǰ
-        if (currentExponent[0] % 2 == 1) {
-            result = bigMod(multiply(result, currentBase), mod);  // ʹĺ
+    size_t bits = (top - 1) * 64;
+    for (uint64_t v = num[top - 1]; v != 0; v >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+// ֽڳȣRSAмģnֽk
+size_t byteLength(const BigInt& num) {
+    return (bitLength(num) + 7) / 8;
+}
+
+// 64λ˼ӣa * b + c + carryĵ64λ64λдcarry128λ
+inline uint64_t mulAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t& carry) {
+    __uint128_t t = (__uint128_t)a * b + c + carry;
+    carry = (uint64_t)(t >> 64);
+    return (uint64_t)t;
+}
+
+// MontgomeryģģģԤn'R^2 mod nR = 2^(64k)kΪģ
+// ͬһԿӽܶʱֻ蹹һΡģ˽Ϊa * b * R^-1 mod nҪ
+struct Montgomery {
+    explicit Montgomery(const BigInt& mod) : n(mod) {
+        while (n.size() > 1 && n.back() == 0) {
+            n.pop_back();
+        }
+        if (!(n[0] & 1)) {
+            throw runtime_error("MontgomeryģҪģΪ");
         }
+        k = n.size();
+        scratch.assign(k + 2, 0);
 
-        // ָ2
-        currentExponent = divide(currentExponent, BigInt{ 2 }).first;
+        // n' = -n^-1 mod 2^64ţٵÿξȷn[0]ģ8Ԫ
+        uint64_t inv = n[0];
+        for (int i = 0; i < 5; ++i) {
+            inv *= 2 - n[0] * inv;
+        }
+        nInv = 0 - inv;
+
+        // R mod nR^2 mod n1ʼӱģn
+        BigInt x(k, 0);
+        x[0] = 1;
+        for (size_t i = 0; i < 128 * k; ++i) {
+            if (i == 64 * k) {
+                one = x;
+            }
+            doubleMod(x);
+        }
+        rr = x;
+    }
+
+    // ת/תMontgomeryxΪͨʾԲСnΪk
+    BigInt toMont(const BigInt& x) const {
+        BigInt r(k, 0);
+        BigInt a = greaterThan(n, normalized(x)) ? x : bigMod(x, n);
+        a.resize(k, 0);
+        mul(a.data(), rr.data(), r.data());
+        return r;
+    }
+
+    BigInt fromMont(const BigInt& x) const {
+        BigInt unit(k, 0), r(k, 0);
+        unit[0] = 1;
+        mul(x.data(), unit.data(), r.data());
+        return normalized(r);
+    }
 
-        // ƽ
-        currentBase = bigMod(multiply(currentBase, currentBase), mod);  // ʹĺ
+    // out = a * b * R^-1 mod nCIOSÿbһ־ԼһΣaboutΪk֣outabͬ
+    void mul(const uint64_t* a, const uint64_t* b, uint64_t* out) const {
+        uint64_t* t = scratch.data();
+        fill(t, t + k + 2, 0);
+
+        for (size_t i = 0; i < k; ++i) {
+            // t += a * b[i]
+            uint64_t carry = 0;
+            for (size_t j = 0; j < k; ++j) {
+                t[j] = mulAdd(a[j], b[i], t[j], carry);
+            }
+            uint64_t sum = t[k] + carry;
+            t[k + 1] = sum < carry;
+            t[k] = sum;
+
+            // t = (t + m * n) / 2^64mʹΪ0
+            uint64_t m = t[0] * nInv;
+            carry = 0;
+            mulAdd(m, n[0], t[0], carry);
+            for (size_t j = 1; j < k; ++j) {
+                t[j - 1] = mulAdd(m, n[j], t[j], carry);
+            }
+            sum = t[k] + carry;
+            t[k - 1] = sum;
+            t[k] = t[k + 1] + (sum < carry);
+        }
+
+        // С2nһn
+        bool geq = t[k] != 0;
+        if (!geq) {
+            geq = true;
+            for (size_t j = k; j-- > 0;) {
+                if (t[j] != n[j]) {
+                    geq = t[j] > n[j];
+                    break;
+                }
+            }
+        }
+        if (geq) {
+            uint64_t borrow = 0;
+            for (size_t j = 0; j < k; ++j) {
+                uint64_t diff = t[j] - n[j] - borrow;
+                borrow = (t[j] < n[j] || (t[j] == n[j] && borrow)) ? 1 : 0;
+                out[j] = diff;
+            }
+        }
+        else {
+            copy(t, t + k, out);
+        }
+    }
+
+    BigInt n;          // ģ
+    size_t k;          // ģ
+    uint64_t nInv;     // -n^-1 mod 2^64
+    BigInt one;        // R mod nMontgomeryе1
+    BigInt rr;         // R^2 mod n
+
+private:
+    static BigInt normalized(BigInt x) {
+        while (x.size() > 1 && x.back() == 0) {
+            x.pop_back();
+        }
+        return x;
     }
 
+    // x = 2x mod nx < nk֣
+    void doubleMod(BigInt& x) const {
+        uint64_t top = x[k - 1] >> 63;
+        for (size_t i = k - 1; i > 0; --i) {
+            x[i] = (x[i] << 1) | (x[i - 1] >> 63);
+        }
+        x[0] <<= 1;
+
+        bool geq = top != 0;
+        if (!geq) {
+            geq = true;
+            for (size_t j = k; j-- > 0;) {
+                if (x[j] != n[j]) {
+                    geq = x[j] > n[j];
+                    break;
+                }
+            }
+        }
+        if (geq) {
+            uint64_t borrow = 0;
+            for (size_t j = 0; j < k; ++j) {
+                uint64_t diff = x[j] - n[j] - borrow;
+                borrow = (x[j] < n[j] || (x[j] == n[j] && borrow)) ? 1 : 0;
+                x[j] = diff;
+            }
+        }
+    }
+
+    mutable vector<uint64_t> scratch;  // ģ˵мÿģʱ
+};
+
+// ָѡ񻬶ڿȣԽ˷Խ٣ԤݱԽ
+int windowBits(size_t exponentBits) {
+    if (exponentBits > 671) return 6;
+    if (exponentBits > 239) return 5;
+    if (exponentBits > 79) return 4;
+    if (exponentBits > 23) return 3;
+    return 1;
+}
+
+// ģ (base^exponent mod n)MontgomeryаڴӸλλֱɨָı
+BigInt modPow(const BigInt& base, const BigInt& exponent, const Montgomery& mont) {
+    size_t bits = bitLength(exponent);
+    int w = windowBits(bits);
+    size_t k = mont.k;
+    auto bit = [&](size_t i) { return (exponent[i / 64] >> (i % 64)) & 1; };
+
+    // Ԥݣtable[i] = base^(2i+1)
+    vector<BigInt> table(size_t(1) << (w - 1));
+    table[0] = mont.toMont(base);
+    if (table.size() > 1) {
+        BigInt square(k);
+        mont.mul(table[0].data(), table[0].data(), square.data());
+        for (size_t i = 1; i < table.size(); ++i) {
+            table[i].resize(k);
+            mont.mul(table[i - 1].data(), square.data(), table[i].data());
+        }
+    }
+
+    BigInt result = mont.one;
+    result.resize(k, 0);
+    bool started = false;
+    for (size_t i = bits; i-- > 0;) {
+        if (!bit(i)) {
+            if (started) {
+                mont.mul(result.data(), result.data(), result.data());
+            }
+            continue;
+        }
+
+        // ȡ1βwλ
+        size_t low = i + 1 >= size_t(w) ? i + 1 - w : 0;
+        while (!bit(low)) {
+            ++low;
+        }
+        size_t value = 0;
+        for (size_t j = i + 1; j-- > low;) {
+            value = (value << 1) | bit(j);
+        }
+
+        if (started) {
+            for (size_t j = low; j <= i; ++j) {
+                mont.mul(result.data(), result.data(), result.data());
+            }
+            mont.mul(result.data(), table[value >> 1].data(), result.data());
+        }
+        else {
+            result = table[value >> 1];
+            started = true;
+        }
+        i = low;
+    }
+
+    return mont.fromMont(result);
+}
+
+// ģ (base^exponent mod mod)ģΪʱʹMontgomeryģ
+BigInt modPow(const BigInt& base, const BigInt& exponent, const BigInt& mod) {
+    if (mod[0] & 1) {
+        return modPow(base, exponent, Montgomery(mod));
+    }
+
+    // żģλƽ-
+    BigInt result = bigMod(BigInt{ 1 }, mod);
+    BigInt currentBase = bigMod(base, mod);
+    for (size_t i = 0, bits = bitLength(exponent); i < bits; ++i) {
+        if ((exponent[i / 64] >> (i % 64)) & 1) {
+            result = bigMod(multiply(result, currentBase), mod);
+        }
+        currentBase = bigMod(multiply(currentBase, currentBase), mod);
+    }
     return result;
 }
 
@@ -231,32 +561,29 @@ BigInt gcd(const BigInt& a, const BigInt& b) {
     return gcd(b, bigMod(a, b));  // ʹĺ
 }
 
-// չŷ㷨ax + by = gcd(a, b)
-tuple<BigInt, BigInt, BigInt> extendedGcd(const BigInt& a, const BigInt& b) {
-    if (equals(b, BigInt{ 0 })) {
-        return { a, BigInt{1}, BigInt{0} };
-    }
+// ģԪ (a^-1 mod m)չŷ㷨aϵʼձ[0, m)ڣָ
+BigInt modInverse(const BigInt& a, const BigInt& m) {
+    BigInt r0 = m, r1 = bigMod(a, m);
+    BigInt t0 = { 0 }, t1 = { 1 };
 
-    auto [g, x, y] = extendedGcd(b, bigMod(a, b));  // ʹĺ
-    BigInt q = divide(a, b).first;
-    BigInt newX = subtract(y, multiply(q, x));
+    while (!equals(r1, BigInt{ 0 })) {
+        auto [q, r2] = divide(r0, r1);
 
-    return { g, y, newX };
-}
+        // t2 = (t0 - q * t1) mod m
+        BigInt qt = bigMod(multiply(q, t1), m);
+        BigInt t2 = greaterThan(qt, t0) ? subtract(add(t0, m), qt) : subtract(t0, qt);
 
-// ģԪ (a^-1 mod m)
-BigInt modInverse(const BigInt& a, const BigInt& m) {
-    auto [g, x, y] = extendedGcd(a, m);
+        r0 = r1;
+        r1 = r2;
+        t0 = t1;
+        t1 = t2;
+    }
 
-    if (!equals(g, BigInt{ 1 })) {
+    if (!equals(r0, BigInt{ 1 })) {
         // Ԫ
         return BigInt{ 0 };
     }
-    else {
-        // ȷΪ
-        BigInt result = bigMod(x, m);  // ʹĺ
-        return result;
-    }
+    return t0;
 }
 
 // 64λתΪ
@@ -297,26 +624,28 @@ string bigIntToHex(const BigInt& num) {
 
 // ʮַתΪ
 BigInt hexToBigInt(const string& hexStr) {
-    BigInt result = { 0 };
-    string temp = hexStr;
+    BigInt result;
 
-    // ÿδ16ʮ֣64λ
-    while (!temp.empty()) {
-        size_t start = max(0, (int)temp.size() - 16);
-        string chunk = temp.substr(start);
-        temp = temp.substr(0, start);
+    // ĩβʼÿδ16ʮ֣64λλǰ
+    for (size_t end = hexStr.size(); end > 0;) {
+        size_t start = end > 16 ? end - 16 : 0;
+        string chunk = hexStr.substr(start, end - start);
+        end = start;
 
         uint64_t val;
         stringstream ss;
         ss << hex << chunk;
         ss >> val;
-
-        // ޸ʹλ
-        BigInt shifted = multiply(result, 0x100000000ULL);  // 2^32
-        shifted = multiply(shifted, 0x100000000ULL);        // ٳ2^32ܹ2^64
-        result = add(shifted, toBigInt(val));
+        result.push_back(val);
     }
 
+    // Ƴǰ
+    while (result.size() > 1 && result.back() == 0) {
+        result.pop_back();
+    }
+    if (result.empty()) {
+        result.push_back(0);
+    }
     return result;
 }
 
@@ -335,6 +664,9 @@ bool isPrime(const BigInt& n, int iterations = 5) {
         s++;
     }
 
+    // ֲԹͬһMontgomery
+    Montgomery mont(n);
+
     // жβ
     for (int i = 0; i < iterations; ++i) {
         // a1 < a < n
@@ -350,7 +682,7 @@ bool isPrime(const BigInt& n, int iterations = 5) {
             a = add(a, BigInt{ 1 });  // ȷa >= 1
         } while (!greaterThan(a, BigInt{ 1 }) || !greaterThan(n, a));
 
-        BigInt x = modPow(a, d, n);
+        BigInt x = modPow(a, d, mont);
 
         if (equals(x, BigInt{ 1 }) || equals(x, subtract(n, BigInt{ 1 }))) {
             continue;
@@ -358,7 +690,7 @@ bool isPrime(const BigInt& n, int iterations = 5) {
 
         bool composite = true;
         for (int j = 0; j < s - 1; ++j) {
-            x = modPow(x, BigInt{ 2 }, n);
+            x = modPow(x, BigInt{ 2 }, mont);
             if (equals(x, subtract(n, BigInt{ 1 }))) {
                 composite = false;
                 break;
@@ -502,7 +834,107 @@ pair<BigInt, BigInt> loadKey(const string& filename) {
     return { exp, mod };
 }
 
-// RSA
+// ֽڴתΪ
+BigInt bytesToBigInt(const uint8_t* data, size_t len) {
+    BigInt result((len + 7) / 8, 0);
+    for (size_t i = 0; i < len; ++i) {
+        result[i / 8] |= static_cast<uint64_t>(data[len - 1 - i]) << ((i % 8) * 8);
+    }
+
+    // Ƴǰ
+    while (result.size() > 1 && result.back() == 0) {
+        result.pop_back();
+    }
+    if (result.empty()) {
+        result.push_back(0);
+    }
+    return result;
+}
+
+// תΪlenֽڵĴֽڴλ㣩
+void bigIntToBytes(const BigInt& num, uint8_t* out, size_t len) {
+    if (byteLength(num) > len) {
+        throw runtime_error("Ŀֽڳ");
+    }
+    for (size_t i = 0; i < len; ++i) {
+        size_t limb = i / 8;
+        uint64_t val = limb < num.size() ? num[limb] : 0;
+        out[len - 1 - i] = static_cast<uint8_t>(val >> ((i % 8) * 8));
+    }
+}
+
+// ļʽ
+//   1棨ɸʽuint32С + uint64ԭʼС֮ÿΪuint32ֽ + 64λ֣λǰ
+//                    ĿΪСֽڣ䣬ûа汾ʶ
+//   2棺ļͷΪħ"RSAF" + uint32汾 + uint32䷽ʽ + uint32ģֽk + uint32ĿС
+//          + uint64ԭʼСΪСˣ֮ÿΪkֽڵĴģĿ鰴PKCS#1 v1.5
+// 1ĿСԶС2^24ħ
+const char FILE_MAGIC[4] = { 'R', 'S', 'A', 'F' };
+const uint32_t FILE_VERSION = 2;
+
+// ䷽ʽ
+const uint32_t PADDING_PKCS1_V15 = 1;
+
+// PKCS#1 v1.5Ŀ00 02 + 8ֽڷ + 00
+const size_t PKCS1_V15_OVERHEAD = 11;
+
+// Сд/ȡļͷе
+void writeLE(ofstream& out, uint64_t val, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.put(static_cast<char>((val >> (i * 8)) & 0xFF));
+    }
+}
+
+uint64_t readLE(ifstream& in, int bytes) {
+    uint8_t buf[8];
+    if (!in.read(reinterpret_cast<char*>(buf), bytes)) {
+        throw runtime_error("ļ");
+    }
+    uint64_t val = 0;
+    for (int i = 0; i < bytes; ++i) {
+        val |= static_cast<uint64_t>(buf[i]) << (i * 8);
+    }
+    return val;
+}
+
+// PKCS#1 v1.5䣨RFC 8017 7.2.1EM = 00 || 02 || PS || 00 || MPSΪֽ
+void pkcs1v15Pad(const uint8_t* msg, size_t msgLen, uint8_t* em, size_t k) {
+    if (msgLen + PKCS1_V15_OVERHEAD > k) {
+        throw runtime_error("Ŀ");
+    }
+
+    // PS벻Ԥ⣬ȡϵͳеֽ³ȡ
+    size_t psLen = k - 3 - msgLen;
+    em[0] = 0x00;
+    em[1] = 0x02;
+    uint8_t* ps = em + 2;
+    secureRandomBytes(ps, psLen);
+    for (size_t i = 0; i < psLen; ++i) {
+        while (ps[i] == 0) {
+            secureRandomBytes(ps + i, 1);
+        }
+    }
+    em[2 + psLen] = 0x00;
+    memcpy(em + 3 + psLen, msg, msgLen);
+}
+
+// ȥPKCS#1 v1.5䣬Ϣemеʼλ
+size_t pkcs1v15Unpad(const uint8_t* em, size_t k) {
+    if (k < PKCS1_V15_OVERHEAD || em[0] != 0x00 || em[1] != 0x02) {
+        throw runtime_error("ʧܣЧ˽Կƥļ𻵣");
+    }
+
+    size_t sep = 2;
+    while (sep < k && em[sep] != 0x00) {
+        ++sep;
+    }
+    if (sep == k || sep < 2 + 8) {
+        throw runtime_error("ʧܣЧ˽Կƥļ𻵣");
+    }
+    return sep + 1;
+}
+
+// RSAܣ2ʽ
 void rsaEncrypt(const string& publicKeyFile, const string& inputFile, const string& outputFile) {
     cout << "ʹRSAļ..." << endl;
 
@@ -510,6 +942,17 @@ void rsaEncrypt(const string& publicKeyFile, const string& inputFile, const stri
     auto [e, n] = loadKey(publicKeyFile);
     cout << "عԿ" << endl;
 
+    // ÿΪkֽڣĿ۳俪
+    size_t k = byteLength(n);
+    if (k <= PKCS1_V15_OVERHEAD) {
+        throw runtime_error("ģ̣޷PKCS#1 v1.5");
+    }
+    size_t maxBlockSize = k - PKCS1_V15_OVERHEAD;
+    cout << "ĿС: " << maxBlockSize << "ֽ" << endl;
+
+    // п鹲ͬһMontgomery
+    Montgomery mont(n);
+
     // ȡļ
     ifstream inFile(inputFile, ios::binary);
     if (!inFile) {
@@ -521,63 +964,41 @@ void rsaEncrypt(const string& publicKeyFile, const string& inputFile, const stri
     streamsize fileSize = inFile.tellg();
     inFile.seekg(0, ios::beg);
 
-    // ĿСֽڣ
-    int maxBlockSize = (n.size() * 8 - 16) / 8;  // Ԥ16λ
-    cout << "ĿС: " << maxBlockSize << "ֽ" << endl;
-
     // ļ
     ofstream outFile(outputFile, ios::binary);
     if (!outFile) {
         throw runtime_error("޷ļ: " + outputFile);
     }
 
-    // дСϢǰ4ֽڣ
-    uint32_t blockSize = maxBlockSize;
-    outFile.write(reinterpret_cast<const char*>(&blockSize), sizeof(blockSize));
-
-    // дԭʼļС8ֽڣ
-    uint64_t originalSize = static_cast<uint64_t>(fileSize);
-    outFile.write(reinterpret_cast<const char*>(&originalSize), sizeof(originalSize));
+    // дļͷ
+    outFile.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    writeLE(outFile, FILE_VERSION, 4);
+    writeLE(outFile, PADDING_PKCS1_V15, 4);
+    writeLE(outFile, k, 4);
+    writeLE(outFile, maxBlockSize, 4);
+    writeLE(outFile, static_cast<uint64_t>(fileSize), 8);
 
-    // ֿ
+    // ֿܣһԲ
     vector<uint8_t> buffer(maxBlockSize);
-    streamsize bytesRead;
+    vector<uint8_t> em(k);
     size_t totalBlocks = 0;
 
     auto start = high_resolution_clock::now();
 
-    // ޸ȷȡȡȡֽ
-    while (inFile.read(reinterpret_cast<char*>(buffer.data()), maxBlockSize)) {
-        bytesRead = inFile.gcount();
-
-        // 飬
-        if (bytesRead < maxBlockSize) {
-            for (streamsize i = bytesRead; i < maxBlockSize; ++i) {
-                buffer[i] = static_cast<uint8_t>(generateRandom64() % 256);
-            }
-        }
-
-        // ֽڻתΪ
-        BigInt m;
-        for (int i = maxBlockSize - 1; i >= 0; i -= 8) {
-            uint64_t val = 0;
-            for (int j = 0; j < 8 && i - j >= 0; ++j) {
-                val |= static_cast<uint64_t>(buffer[i - j]) << (j * 8);
-            }
-            m.push_back(val);
+    while (true) {
+        inFile.read(reinterpret_cast<char*>(buffer.data()), maxBlockSize);
+        streamsize bytesRead = inFile.gcount();
+        if (bytesRead <= 0) {
+            break;
         }
 
         // : c = m^e mod n
-        BigInt c = modPow(m, e, n);
-
-        // дܺĿС4ֽڣ
-        uint32_t encryptedSize = c.size() * 8;
-        outFile.write(reinterpret_cast<const char*>(&encryptedSize), sizeof(encryptedSize));
+        pkcs1v15Pad(buffer.data(), static_cast<size_t>(bytesRead), em.data(), k);
+        BigInt c = modPow(bytesToBigInt(em.data(), k), e, mont);
 
-        // дܺ
-        for (auto chunk : c) {
-            outFile.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
-        }
+        // д붨kֽڵ
+        bigIntToBytes(c, em.data(), k);
+        outFile.write(reinterpret_cast<const char*>(em.data()), k);
 
         totalBlocks++;
         if (totalBlocks % 10 == 0) {
@@ -585,36 +1006,6 @@ void rsaEncrypt(const string& publicKeyFile, const string& inputFile, const stri
         }
     }
 
-    // һĿ
-    bytesRead = inFile.gcount();
-    if (bytesRead > 0) {
-        // 
-        for (streamsize i = bytesRead; i < maxBlockSize; ++i) {
-            buffer[i] = static_cast<uint8_t>(generateRandom64() % 256);
-        }
-
-        // תΪ
-        BigInt m;
-        for (int i = maxBlockSize - 1; i >= 0; i -= 8) {
-            uint64_t val = 0;
-            for (int j = 0; j < 8 && i - j >= 0; ++j) {
-                val |= static_cast<uint64_t>(buffer[i - j]) << (j * 8);
-            }
-            m.push_back(val);
-        }
-
-        BigInt c = modPow(m, e, n);
-
-        // дܽ
-        uint32_t encryptedSize = c.size() * 8;
-        outFile.write(reinterpret_cast<const char*>(&encryptedSize), sizeof(encryptedSize));
-        for (auto chunk : c) {
-            outFile.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
-        }
-
-        totalBlocks++;
-    }
-
     auto end = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(end - start);
 
@@ -622,69 +1013,97 @@ void rsaEncrypt(const string& publicKeyFile, const string& inputFile, const stri
     cout << "ܽ浽: " << outputFile << endl;
 }
 
-// RSA
-void rsaDecrypt(const string& privateKeyFile, const string& inputFile, const string& outputFile) {
-    cout << "ʹRSAļ..." << endl;
+// ܵ2ʽļѶħ
+size_t decryptV2(ifstream& inFile, ofstream& outFile, const BigInt& d, const Montgomery& mont) {
+    const BigInt& n = mont.n;
+    uint32_t version = static_cast<uint32_t>(readLE(inFile, 4));
+    if (version != FILE_VERSION) {
+        throw runtime_error("ֵ֧ļļ汾: " + to_string(version));
+    }
+    uint32_t padding = static_cast<uint32_t>(readLE(inFile, 4));
+    if (padding != PADDING_PKCS1_V15) {
+        throw runtime_error("ֵ֧䷽ʽ: " + to_string(padding));
+    }
+    size_t k = static_cast<size_t>(readLE(inFile, 4));
+    size_t maxBlockSize = static_cast<size_t>(readLE(inFile, 4));
+    uint64_t originalSize = readLE(inFile, 8);
 
-    // ˽Կ
-    auto [d, n] = loadKey(privateKeyFile);
-    cout << "˽Կ" << endl;
+    if (k != byteLength(n) || maxBlockSize + PKCS1_V15_OVERHEAD > k) {
+        throw runtime_error("˽Կļƥ");
+    }
 
-    // ļ
-    ifstream inFile(inputFile, ios::binary);
-    if (!inFile) {
-        throw runtime_error("޷ļ: " + inputFile);
+    vector<uint8_t> em(k);
+    size_t totalBlocks = 0;
+    uint64_t bytesWritten = 0;
+
+    while (inFile.peek() != EOF) {
+        if (!inFile.read(reinterpret_cast<char*>(em.data()), k)) {
+            throw runtime_error("ļ");
+        }
+
+        // : m = c^d mod n
+        BigInt c = bytesToBigInt(em.data(), k);
+        if (!greaterThan(n, c)) {
+            throw runtime_error("Ŀ鳬ģΧ");
+        }
+        bigIntToBytes(modPow(c, d, mont), em.data(), k);
+
+        size_t msg = pkcs1v15Unpad(em.data(), k);
+        size_t msgLen = k - msg;
+        if (msgLen > maxBlockSize || bytesWritten + msgLen > originalSize) {
+            throw runtime_error("ܽԭʼļС");
+        }
+        outFile.write(reinterpret_cast<const char*>(em.data() + msg), msgLen);
+        bytesWritten += msgLen;
+
+        totalBlocks++;
+        if (totalBlocks % 10 == 0) {
+            cout << "ѽ " << totalBlocks << " ..." << endl;
+        }
     }
 
-    // ȡСϢ
-    uint32_t maxBlockSize;
-    inFile.read(reinterpret_cast<char*>(&maxBlockSize), sizeof(maxBlockSize));
+    if (bytesWritten != originalSize) {
+        throw runtime_error("ļ");
+    }
+    return totalBlocks;
+}
 
+// ܵ1棨ɸʽļmaxBlockSizeΪѶļͷһֶ
+size_t decryptV1(ifstream& inFile, ofstream& outFile, uint32_t maxBlockSize, const BigInt& d, const Montgomery& mont) {
     // ȡԭʼļС
     uint64_t originalSize;
     inFile.read(reinterpret_cast<char*>(&originalSize), sizeof(originalSize));
 
-    // ļ
-    ofstream outFile(outputFile, ios::binary);
-    if (!outFile) {
-        throw runtime_error("޷ļ: " + outputFile);
-    }
-
-    // ֿ
+    vector<uint8_t> buffer(maxBlockSize);
     size_t totalBlocks = 0;
     uint64_t bytesWritten = 0;
 
-    auto start = high_resolution_clock::now();
-
     while (inFile.peek() != EOF) {
-        // ȡܿС
+        // ȡܿСɸʽдֽ
         uint32_t encryptedSize;
         inFile.read(reinterpret_cast<char*>(&encryptedSize), sizeof(encryptedSize));
 
-        int numChunks = (encryptedSize + 63) / 64;
+        size_t numChunks = encryptedSize / 8;
 
         // ȡ
         BigInt c;
-        for (int i = 0; i < numChunks; ++i) {
+        for (size_t i = 0; i < numChunks; ++i) {
             uint64_t chunk;
             inFile.read(reinterpret_cast<char*>(&chunk), sizeof(chunk));
             c.push_back(chunk);
         }
-
-        // : m = c^d mod n
-        BigInt m = modPow(c, d, n);
-
-        // תֽڻ
-        vector<uint8_t> buffer(maxBlockSize, 0);
-        for (size_t i = 0; i < m.size() && i * 8 < maxBlockSize; ++i) {
-            uint64_t val = m[i];
-            for (int j = 0; j < 8 && i * 8 + j < maxBlockSize; ++j) {
-                buffer[i * 8 + j] = static_cast<uint8_t>((val >> (j * 8)) & 0xFF);
-            }
+        if (!inFile) {
+            throw runtime_error("ļ");
+        }
+        while (c.size() > 1 && c.back() == 0) {
+            c.pop_back();
         }
 
+        // : m = c^d mod nɸʽĿ鰴˴ڿСֽ
+        bigIntToBytes(modPow(c, d, mont), buffer.data(), maxBlockSize);
+
         // ҪдֽһmaxBlockSize
-        streamsize writeSize = maxBlockSize;
+        uint64_t writeSize = maxBlockSize;
         if (bytesWritten + writeSize > originalSize) {
             writeSize = originalSize - bytesWritten;
         }
@@ -698,6 +1117,53 @@ void rsaDecrypt(const string& privateKeyFile, const string& inputFile, const str
             cout << "ѽ " << totalBlocks << " ..." << endl;
         }
     }
+    return totalBlocks;
+}
+
+// RSAܣļͷԶʶʽ汾
+void rsaDecrypt(const string& privateKeyFile, const string& inputFile, const string& outputFile) {
+    cout << "ʹRSAļ..." << endl;
+
+    // ˽Կ
+    auto [d, n] = loadKey(privateKeyFile);
+    cout << "˽Կ" << endl;
+
+    // ļ
+    ifstream inFile(inputFile, ios::binary);
+    if (!inFile) {
+        throw runtime_error("޷ļ: " + inputFile);
+    }
+
+    // ǰ4ֽΪħ2棩С1棩
+    char head[4];
+    if (!inFile.read(head, sizeof(head))) {
+        throw runtime_error("ļ");
+    }
+
+    // ļ
+    ofstream outFile(outputFile, ios::binary);
+    if (!outFile) {
+        throw runtime_error("޷ļ: " + outputFile);
+    }
+
+    // п鹲ͬһMontgomery
+    Montgomery mont(n);
+
+    auto start = high_resolution_clock::now();
+
+    size_t totalBlocks;
+    if (memcmp(head, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0) {
+        totalBlocks = decryptV2(inFile, outFile, d, mont);
+    }
+    else {
+        uint32_t maxBlockSize;
+        memcpy(&maxBlockSize, head, sizeof(maxBlockSize));
+        if (maxBlockSize == 0 || maxBlockSize >= byteLength(n)) {
+            throw runtime_error("޷ʶļļʽ");
+        }
+        cout << "ɸʽļĿС: " << maxBlockSize << "ֽ" << endl;
+        totalBlocks = decryptV1(inFile, outFile, maxBlockSize, d, mont);
+    }
 
     auto end = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(end - start);